@@ -12,7 +12,7 @@
 #include "quick/imath.h"
 #include "quick/heap.h"
 #include "quick/sortable.h"
-#include "quick/sorted.h"
+#include "quick/bitset.h"
 #include "quick/table.h"
 #include "v4p.h"
 #include "v4pi.h"
@@ -22,27 +22,73 @@
 // Forward declarations
 V4pPolygonP v4p_computeLimits(V4pPolygonP p);
 
-static V4pCollisionCallback collisionCallback = NULL;
+// Openable table entry of ActiveEdges never opened (starting below the view or ending above it)
+#define V4P_UNHASHED -1
 
-#define YHASH_SIZE 512
-#define YHASH_MASK 511
+// Partial refresh renders dirty rows separated by less clean rows than this at once
+#define V4P_DIRTY_GAP 8
+
+// Scene grid levels, cells of a level being twice larger than those of the previous one
+#define V4P_GRID_LEVELS 8
+
+// Transform of the prototype points into those of an instance (see v4p_transformClone)
+typedef struct v4p_transform_s {
+    V4pCoord dx, dy;  // Position delta
+    V4pCoord anchor_x, anchor_y;  // Rotation and zoom anchor
+    V4pCoord zoom_x, zoom_y;  // Zoom (256 = 1:1)
+    int angle;  // Rotation angle in [0, 512)
+} V4pTransform;
+
+/**
+ * Point lists
+ * Points are linked from the last added one, or held by an array in packed builds (V4P_PACKED): the array starts
+ * with a head ending the list, followed by the points from the first added one, the list being read backward.
+ */
+#ifdef V4P_PACKED
+#define V4P_POINTS_HEAD ((uint16_t) 0xFFFE)  // b of the array head, whose x is V4P_NIL
+#define V4P_NEXT_POINT(s) ((s)[-1].x == V4P_NIL && (s)[-1].b == V4P_POINTS_HEAD ? NULL : (s) - 1)
+#else
+#define V4P_NEXT_POINT(s) ((s)->next)
+#endif
 
 // Polygon type
 typedef struct v4p_polygon_s {
+    // Read at each frame, polygons being unchanged or not
     V4pProps props;  // Property flags
-    V4pPointP point1;  // List of points (only 1 for disk)
-    V4pColor color;  // V4pColor (any data needed by the drawing function)
     V4pLayer z;  // Depth
+    V4pColor color;  // V4pColor (any data needed by the drawing function)
     V4pCollisionLayer collisionMask;  // Collision mask
-    V4pPolygonP sub1;  // Subs list
+    uint32_t rank;  // Depth rank among visible polygons of the frame being rendered
     V4pPolygonP next;  // Subs list link
-    V4pPolygonP parent;  // Parent polygon reference (for clones)
-    V4pCoord anchor_x, anchor_y;  // Rotation anchor point (default: 0,0)
-    V4pCoord minx, maxx, miny, maxy;  // Bounding box
-    V4pCoord minyv, maxyv;  // Vertical boundaries in view coordinates
+    V4pPolygonP* prev;  // Link to this polygon in its list (scene or subs list), NULL if in none
+    V4pPolygonP* list;  // Head of the list holding this polygon, NULL if in none
+    V4pPolygonP sub1;  // Subs list
     List ActiveEdge1;  // ActiveEdges list
-    uint32_t id;  // Unique polygon ID
+    uint32_t hashed;  // Generation of the openable table holding its ActiveEdges (0: none)
+    V4pCoord minyv, maxyv;  // Rows [minyv, maxyv) crossed by its ActiveEdges in view (once hashed)
+    V4pCoord treeMinX, treeMaxX, treeMinY, treeMaxY;  // Bounding box of the polygon and its subs
+    bool treeRelative;  // Subtree holding relative polygons (never culled)
+    V4pCoord drawnMinY, drawnMaxY;  // Display rows [min, max) drawn at last render (partial refresh)
+    // Read once changed
+    V4pPointP point1;  // List of points (only 1 for disk)
+#ifdef V4P_PACKED
+    V4pPoint* points;  // Points array: list head, then points from the first added one (point1 being the last)
+    int pointsNb, pointsSize;
+    V4pPolygonP nextPacked;  // Polygons of the context link (see V4pContext.packed1)
+    V4pPolygonP* prevPacked;  // Link to this polygon
+#endif
     uint32_t stroke;  // Stroke width (1 = 1px stroke, 0 = filled)
+    V4pCoord minx, maxx, miny, maxy;  // Bounding box
+    V4pCoord anchor_x, anchor_y;  // Rotation anchor point (default: 0,0)
+    V4pPolygonP parent;  // Parent polygon reference (for clones)
+    uint32_t batchWritten, batchRead;  // Generation of the last batch runs writing, reading its points
+    V4pPolygonP owner;  // Polygon holding this one in its subs list (NULL at scene level)
+    struct v4p_gridItem_s* gridItem;  // Record in the scene grid (scene level polygons of a gridded scene)
+    uint32_t id;  // Unique polygon ID
+    V4pPolygonP instance1;  // Instances of this polygon (see v4p_newInstance)
+    V4pPolygonP nextInstance;  // Instances list link (instance polygons)
+    V4pPolygonP* prevInstance;  // Link to this instance
+    V4pTransform transform;  // Transform of the parent points (instance polygons)
 } Polygon;
 
 // ActiveEdge type
@@ -53,6 +99,7 @@ typedef struct activeEdge_s {
     V4pCoord h;  // Remaining scanlines to process
     V4pCoord x;  // Current x coordinate (in view) at y=scanline
     bool isArc;  // ellipse arc edge
+    bool isBezier;  // Bezier curve edge
     union {
         struct { // Straight edge (Bresenham)
             V4pCoord o1;  // Offset when accumulator under limit
@@ -68,30 +115,131 @@ typedef struct activeEdge_s {
             V4pCoord a, b;       // semi-axes in view coordinates
             V4pCoord a2, b2;     // a² and b², precomputed
             V4pCoord ea;         // ceil(a²/4), precomputed
-            V4pCoord t;          // McIlroy accumulator
+            int64_t t;           // McIlroy accumulator (overflows 32 bits past radii of a thousand)
             V4pCoord ex;         // x offset from center (always >= 0)
             V4pCoord ey;         // y offset from center (always >= 0)
             V4pCoord lex;        // previous ex (for stroke edge)
             int8_t   xdir;       // +1 = right side, -1 = left side
             int8_t   ydir;       // -1 = top-to-bottom (usual), +1 = bottom-to-top
         } arc;
+        struct { // Bezier curve edge, monotonic in y (forward differencing)
+            V4pCoord c1x, c1y, c2x, c2y;  // control points in scene coordinates (c2 = c1 for a quadratic curve)
+            V4pCoord c1vx, c1vy, c2vx, c2vy;  // control points in view
+            int64_t fx, fy;  // curve point at current step, in 1/N³ pixels (N steps from a to b)
+            int64_t dx1, dy1, dx2, dy2, dx3, dy3;  // forward differences at current step
+            V4pCoord steps;  // steps left to b
+            V4pCoord nx;  // x at next row (stroke edge)
+            int8_t shift;  // log2(N³)
+            int8_t degree;  // 2 for a quadratic curve, 3 for a cubic one
+        } bezier;
     } as;
     bool isStroke;  // If true: plot 1px per scanline, don't toggle fill
+    V4pCoord bucket;  // Openable table entry (while its polygon is hashed), or V4P_UNHASHED
+    // Arc edges of a same ellipse along the same rows (mirror quarters of a disk, stroke twins) share
+    // a single McIlroy evaluation, the newest of them opening the others along with itself
+    struct activeEdge_s* lead;  // Newer arc edge of the same ellipse and rows
+    struct activeEdge_s* host;  // Edge opening this one along with itself (set when hashed)
+    struct activeEdge_s* rider;  // First edge opened along with this one, or next one along with the host
 } ActiveEdge;
 
 typedef struct activeEdge_s* ActiveEdgeP;
 
-// Forward declaration for Tree (defined in quick/sorted.h)
-typedef struct sTree QuickTree;
+// Scene level polygon tree registered in a scene grid
+typedef struct v4p_gridItem_s {
+    V4pPolygonP p;  // Tree root, NULL once removed from the scene
+    struct v4p_grid_s* grid;
+    struct v4p_gridItem_s** bucket;  // Bucket holding the item, NULL while not registered
+    int level;  // Grid level of its cell, V4P_GRID_LEVELS when held aside
+    struct v4p_gridItem_s* next;  // Bucket link
+    struct v4p_gridItem_s** prev;  // Link to this item
+    V4pCoord minx, maxx, miny, maxy;  // Tree box when indexed
+    bool moved;  // Tree changed since last frame, to be indexed again
+    struct v4p_gridItem_s* nextMoved;  // Moved items list link
+    int shown;  // Index among items shown at last frame, or -1
+    uint32_t order;  // Scene order (the greater, the sooner in the scene list)
+    uint32_t met;  // Last query the item was met by
+} V4pGridItem;
+
+// Spatial index of a scene level polygons (see v4p_setSceneGrid)
+// A hierarchy of loose uniform grids: trees are registered in the cell holding their box center, at
+// the first level whose cells are as large as their box, so that it overflows the cell by half a cell
+// at most. Cells are hashed into buckets, so that the world has no bounds.
+typedef struct v4p_grid_s {
+    V4pCoord cellSize;  // Cells size at level 0
+    V4pGridItem** buckets;  // Items by cell hash, followed by items held aside
+    int bucketsNb;  // Power of 2
+    int itemsNb;  // Items in cell buckets
+    int levelItemsNb[V4P_GRID_LEVELS];  // Items per level
+    QuickHeap itemHeap;
+    V4pGridItem* moved;  // Items to be indexed again at next frame
+    V4pGridItem** shown;  // Items whose tree overlapped the view at last frame
+    int shownNb, shownSize;
+    uint32_t order;  // Last scene order given
+    uint32_t query;  // Last query
+} V4pGrid;
+
+// Mark a polygon as changed, and the subtree boxes holding it as outdated
+void v4p_changed(V4pPolygonP p);
 
-// Create a new point
-V4pPointP v4p_newPoint(V4pCoord x, V4pCoord y, V4pCoord a, V4pCoord b);
+// Collision reported by a band rendered in parallel, until handed over to the callback
+typedef struct v4p_collision_s {
+    V4pCollisionLayer i1, i2;
+    V4pCoord y, x1, x2;
+    V4pPolygonP p1, p2;
+} V4pCollision;
 
-// Destroy a point
-void v4p_destroyPoint(V4pPointP point);
+// Opened ActiveEdges of a band, as a structure of arrays indexed by slot
+// Straight edges are stepped right in these arrays, all at once, arc and Bezier edges in private copies
+// (arcs). These edges and free slots have zero offsets and remainders, so that stepping leaves them as is.
+// Sorting opened edges by x permutes their slots in order.
+typedef struct v4p_openedEdges_s {
+    int* order;  // Slots of opened edges, ordered by x
+    int orderNb;
+    int* merged;  // Room for sorting and merging slots
+    int* freeSlots;  // Slots of closed edges, to be used again
+    int freeSlotsNb, slotsNb, slotsSize;
+    V4pCoord* x;  // Current x coordinate (in view)
+    V4pCoord* h;  // Remaining scanlines to process
+    V4pCoord *o1, *o2, *s, *r1, *r2;  // Bresenham offsets, accumulator and remainders (see ActiveEdge)
+    uint32_t* rank;  // Rank of the edge polygon
+    int* arc;  // Index of the arc or Bezier edge copy, -1 for a straight edge
+    int8_t* side;  // x direction from the arc center, doubled for a stroke edge (lagging x offset), 0 off arcs
+    ActiveEdge* arcs;  // Private copies of opened arc and Bezier edges, stepped once for all slots sharing them
+    int* arcUsers;  // Count of slots sharing each arc copy
+    int* freeArcs;  // Copies of closed arc edges, to be used again
+    int freeArcsNb, arcsNb, arcsSize;
+} V4pOpenedEdges;
 
-// Mark a polygon as changed
-#define v4p_changed(P) ((P)->props |= V4P_CHANGED)
+// Horizontal band of scanlines [y0, y1) with its own scanline state
+// Several bands are rendered in parallel (see v4p_setRenderThreads), their output being
+// buffered then handed over to the backend and collision callback in scanline order.
+typedef struct v4p_band_s {
+    V4pCoord y0, y1;  // Scanlines range
+    bool buffered;  // Output buffered (band rendered in parallel with others)
+    bool failed;  // Out of memory while rendering
+    V4pOpenedEdges edges;  // Opened ActiveEdges
+    QuickBitset openedPolygons;  // Ranks of opened polygons at current scanline
+    V4pSpan* spans;  // Spans of current scanline, or of all scanlines when buffered
+    int spansNb, spansSize;
+    int rowStart;  // First span of current scanline
+    int* rowEnds;  // End of spans per scanline (buffered)
+    int rowEndsSize;
+    V4pCollision* collisions;  // Collisions (buffered)
+    int collisionsNb, collisionsSize;
+    V4pRenderStats stats;  // Band render statistics, summed up into context ones
+} V4pBand;
+
+// Spans of a display row as last drawn, compared to the spans of the next frame (V4PI_PARTIAL)
+typedef struct v4p_drawnRow_s {
+    V4pSpan* spans;
+    int spansNb, spansSize;  // spansNb < 0: row content unknown
+} V4pDrawnRow;
+
+// Polygon fields read by the scanline loop, copied by rank once per frame (see v4p_rankPolygons)
+typedef struct v4p_rankedPolygon_s {
+    V4pColor color;
+    V4pCollisionMask collisionMask;
+} V4pRankedPolygon;
 
 // V4P context
 typedef struct v4p_context_s {
@@ -103,9 +251,32 @@ typedef struct v4p_context_s {
     V4pColor background;  // background color
     int debug1;
     QuickHeap pointHeap, polygonHeap, activeEdgeHeap;
-    List openedAEList;  // ActiveEdge lists
-    QuickTable openableAETable;  // ActiveEdge Hash Table
-    QuickTree* openedPolygons;  // AVL tree of active polygons sorted by depth
+    QuickHeap listHeap;  // List nodes (ActiveEdge lists, visible polygons)
+    QuickTable openableAETable;  // ActiveEdges by starting row in view, then those starting above the view
+    uint32_t tableGeneration;  // Incremented whenever the openable table is rebuilt (see V4pPolygon.hashed)
+    List visiblePolygons;  // Visible polygons met while building AE lists (to be ranked)
+    V4pPolygonP* rankedPolygons;  // Visible polygons by rank (depth order), rank = index
+    V4pRankedPolygon* ranks;  // Their scanline loop fields, rank = index
+    int rankedPolygonsNb, rankedPolygonsSize;
+    V4pPoint* instancePoints;  // Transformed points of an instance
+    int instancePointsSize;
+    V4pPolygonP instancePointsOf;  // Instance whose points are held by instancePoints, until it changes
+    V4pPointP instancePoint1;  // Its points list
+    int* batchJobs;  // Clone jobs of the batch run being transformed (see v4p_transformBatch)
+    int* batchOrder;  // Same jobs by angle, following batchJobs in its allocation
+    int batchJobsSize;
+    uint32_t batchGeneration;  // Incremented for each batch run (see V4pPolygon.batchWritten)
+    V4pBand* bands;  // Scanline bands of the frame being rendered
+    int bandsNb, bandsSize;
+    int threads;  // Rendering threads (see v4p_setRenderThreads)
+    V4pCollisionCallback collisionCallback;  // see v4p_setCollisionCallback
+    bool partialRefresh;  // Render dirty rows only (see v4p_setPartialRefresh)
+    bool allDirty;  // Whole display to be rendered at next frame
+    uint8_t* dirtyRows;  // Rows to be rendered at next frame (partial refresh)
+    int dirtyRowsSize;
+    V4pDrawnRow* drawnRows;  // Spans of the display rows as last drawn (V4PI_PARTIAL)
+    int drawnRowsNb;
+    V4piContextP drawnDisplay;  // Display showing these rows
     V4pCoord viewWidth, viewHeight;  // View dimensions (viewMaxX - viewMinX, viewMaxY - viewMinY)
     // Integer scaling factors for coordinate transformations
     // Uses quotient-remainder technique to avoid overflow (see integer_scaling.md)
@@ -116,8 +287,49 @@ typedef struct v4p_context_s {
     bool scaling;  // Is scaling necessary?
     uint32_t changes;
     uint32_t nextId;
+#ifdef V4P_PACKED
+    V4pPolygonP packed1;  // Polygons allocated by the context, their points arrays being freed with it
+#endif
+    V4pRenderStats stats;  // Render statistics (see V4P_STATS)
 } V4pContext;
 
+/**
+ * Render statistics
+ * Build with STATS=1 (-DV4P_STATS=1) to count, STATS=2 to time render phases too.
+ * Like v4p_trace tags, these macros compile to nothing when disabled (only referencing their stats).
+ */
+#ifndef V4P_STATS
+    #define V4P_STATS 0
+#endif
+#if V4P_STATS >= 1
+    #define v4p_count(STATS, COUNTER, N) ((STATS).COUNTER += (N))
+#else
+    #define v4p_count(STATS, COUNTER, N) ((void) (STATS))
+#endif
+#if V4P_STATS >= 2
+    #define v4p_timerStart(T) int64_t T = v4p_getNanos()
+    #define v4p_timerStop(STATS, TIMING, T) ((STATS).TIMING += v4p_getNanos() - (T))
+#else
+    #define v4p_timerStart(T) ((void) 0)
+    #define v4p_timerStop(STATS, TIMING, T) ((void) (STATS))
+#endif
+
+/**
+ * SIMD stepping of straight opened edges (see v4p_stepEdges)
+ * The kernel follows the target instruction sets: AVX2 (make SIMD=avx2), SSE2 (x86-64) or NEON (ARM).
+ * Other targets (PalmOS, MCUs) and builds with SIMD=0 (-DV4P_NO_SIMD) step edges with scalar code.
+ */
+#if ! defined(V4P_NO_SIMD) && defined(__AVX2__)
+    #include <immintrin.h>
+    #define V4P_SIMD_AVX2
+#elif ! defined(V4P_NO_SIMD) && defined(__SSE2__)
+    #include <emmintrin.h>
+    #define V4P_SIMD_SSE2
+#elif ! defined(V4P_NO_SIMD) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define V4P_SIMD_NEON
+#endif
+
 /**
  * About screen vs view ratios:
  * divyvu == 0 when view bigger than screen (zoom out)
@@ -4,12 +4,37 @@
 #include "clipping.h"
 #include "_v4p.h"
 
+// Clipped path point, clipped paths being linked lists whatever the polygon points storage (see V4pPoint)
+typedef struct clip_point_s {
+    V4pCoord x, y;
+    uint16_t a, b;
+    struct clip_point_s* next;
+} ClipPoint, *ClipPointP;
+
+static ClipPointP newClipPoint(V4pCoord x, V4pCoord y, uint16_t a, uint16_t b) {
+    ClipPointP point = v4p_malloc(sizeof(ClipPoint));
+    point->x = x;
+    point->y = y;
+    point->a = a;
+    point->b = b;
+    point->next = NULL;
+    return point;
+}
+
+static void destroyClipPoints(ClipPointP points) {
+    while (points) {
+        ClipPointP next = points->next;
+        v4p_free(points);
+        points = next;
+    }
+}
+
 // Simplified clipEdge for axis-aligned clipping
-static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord, bool isMinEdge) {
-    V4pPointP result = NULL;
-    V4pPointP prev = NULL;
-    V4pPointP current = subject;
-    V4pPointP subStart = subject;
+static ClipPointP clipEdge(ClipPointP subject, bool isVertical, V4pCoord clipCoord, bool isMinEdge) {
+    ClipPointP result = NULL;
+    ClipPointP prev = NULL;
+    ClipPointP current = subject;
+    ClipPointP subStart = subject;
 
     // We clip sub-path by sub-path because of JUMP points that separates multiple sub-paths.
     // Nested loop closes every sub-path.
@@ -21,13 +46,13 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
 
     while (subStart != NULL) {
         // Find the last real point of this sub-path (before next JUMP or end)
-        V4pPointP lastPoint = NULL;
-        V4pPointP scan = subStart;
+        ClipPointP lastPoint = NULL;
+        ClipPointP scan = subStart;
         int pointCount = 0;
 
         // Track arc information
-        V4pPointP arcCenter = NULL;  // Current arc center point
-        V4pPointP ultimateCenter = NULL;  // center to be put at the result list end
+        ClipPointP arcCenter = NULL;  // Current arc center point
+        ClipPointP ultimateCenter = NULL;  // center to be put at the result list end
         while (scan != NULL) {
             if (scan->x == V4P_NIL && scan->y == V4P_NIL) {
                 break;  // JUMP
@@ -44,7 +69,7 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
         }
 
         // Compute prevPoint/prevInside from this sub-path's last point
-        V4pPointP prevPoint = lastPoint;
+        ClipPointP prevPoint = lastPoint;
         bool prevInside = false;
         if (prevPoint != NULL) {
             V4pCoord lx = prevPoint->x;
@@ -63,7 +88,7 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
             if (current->x == V4P_NIL && current->y == V4P_NIL) {
                 // Only emit JUMP if output is non-empty (avoids leading JUMPs)
                 if (result != NULL) {
-                    V4pPointP jump = v4p_newPoint(V4P_NIL, V4P_NIL, 0, 0);
+                    ClipPointP jump = newClipPoint(V4P_NIL, V4P_NIL, 0, 0);
                     prev->next = jump;
                     prev = jump;
                 }
@@ -94,7 +119,7 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
                 // both arc ends are inside, one includes the arcCenter back
                 v4p_trace(TRANSFORM, "both arc ends are inside, one includes the arcCenter back\n");
 
-                V4pPointP arcCenterPoint = v4p_newPoint(arcCenter->x, arcCenter->y, arcCenter->a, arcCenter->b);
+                ClipPointP arcCenterPoint = newClipPoint(arcCenter->x, arcCenter->y, arcCenter->a, arcCenter->b);
                 if (prevPoint == lastPoint) {
                     // special case: one puts the center at the end of the list, like in the initial list
                     v4p_trace(TRANSFORM,
@@ -117,15 +142,15 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
                 v4p_trace(TRANSFORM, "Intersection on inside/outside transition (%d,%d)-(%d,%d)\n", prevX, prevY, x, y);
 
                 // Compute intersection with the clip edge
-                V4pPointP intersection = v4p_newPoint(0, 0, 0, 0);
+                ClipPointP intersection = newClipPoint(0, 0, 0, 0);
 
                 // Check if we have an arc transition (both prev and current are arc-ends)
                 bool isArcTransition = (arcCenter != NULL);
-                V4pPointP arcCenterPoint = NULL;
+                ClipPointP arcCenterPoint = NULL;
                 if (isArcTransition) {
                     // For arc transitions, we need to preserve the arc structure
                     // First, add the arc center point to maintain the arc relationship
-                    arcCenterPoint = v4p_newPoint(arcCenter->x, arcCenter->y, arcCenter->a, arcCenter->b);
+                    arcCenterPoint = newClipPoint(arcCenter->x, arcCenter->y, arcCenter->a, arcCenter->b);
                     v4p_trace(TRANSFORM, "arc intersection with center (%d, %d)\n", arcCenterPoint->x,
                               arcCenterPoint->y);
 
@@ -233,7 +258,7 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
 
             // Emit current point if inside
             if (currentInside) {
-                V4pPointP newPoint = v4p_newPoint(x, y, 0, 0);
+                ClipPointP newPoint = newClipPoint(x, y, 0, 0);
 
                 if (result == NULL) {
                     result = newPoint;
@@ -267,11 +292,18 @@ static V4pPointP clipEdge(V4pPointP subject, bool isVertical, V4pCoord clipCoord
     return result;
 }
 
+// Clip a path against an edge, the path being replaced by the clipped one
+static ClipPointP clipPathEdge(ClipPointP subject, bool isVertical, V4pCoord clipCoord, bool isMinEdge) {
+    ClipPointP clipped = clipEdge(subject, isVertical, clipCoord, isMinEdge);
+    destroyClipPoints(subject);
+    return clipped;
+}
+
 // Clip a polygon against a rectangle using Sutherland-Hodgman algorithm
 V4pPolygonP v4p_recPolygonClipClone(bool estSub, V4pPolygonP p, V4pPolygonP c, V4pCoord x0, V4pCoord y0, V4pCoord x1,
                                     V4pCoord y1) {
-    V4pPointP sp, sc;
-    V4pPointP clippedPoints = NULL;
+    V4pPointP sp;
+    ClipPointP clippedPoints = NULL;
 
     if (p->miny == V4P_NIL) {
         v4p_computeLimits(p);
@@ -286,34 +318,40 @@ V4pPolygonP v4p_recPolygonClipClone(bool estSub, V4pPolygonP p, V4pPolygonP c, V
         } else {
             // Copy points from p to a temporary list
             sp = p->point1;
-            V4pPointP* tail = &clippedPoints;  // Pointer to the end of the list
+            ClipPointP* tail = &clippedPoints;  // Pointer to the end of the list
             while (sp) {
-                V4pPointP newPoint = v4p_newPoint(sp->x, sp->y, sp->a, sp->b);
+                ClipPointP newPoint = newClipPoint(sp->x, sp->y, sp->a, sp->b);
                 *tail = newPoint;
                 tail = &newPoint->next;
-                sp = sp->next;
+                sp = v4p_nextPoint(sp);
             }
 
             // Clip against each edge of the rectangle
             // Order: top, right, bottom, left (clockwise)
             v4p_trace(TRANSFORM, "clipping Top edge (horizontal, min y)\n");
-            clippedPoints = clipEdge(clippedPoints, false, y0, true);  // Top edge (horizontal, min y)
+            clippedPoints = clipPathEdge(clippedPoints, false, y0, true);  // Top edge (horizontal, min y)
             v4p_trace(TRANSFORM, "clipping Right edge (vertical, max x)\n");
-            clippedPoints = clipEdge(clippedPoints, true, x1, false);  // Right edge (vertical, max x)
+            clippedPoints = clipPathEdge(clippedPoints, true, x1, false);  // Right edge (vertical, max x)
             v4p_trace(TRANSFORM, "clipping Bottom edge (horizontal, max y)\n");
-            clippedPoints = clipEdge(clippedPoints, false, y1, false);  // Bottom edge (horizontal, max y)
+            clippedPoints = clipPathEdge(clippedPoints, false, y1, false);  // Bottom edge (horizontal, max y)
             v4p_trace(TRANSFORM, "clipping Left edge (vertical, min x)\n");
-            clippedPoints = clipEdge(clippedPoints, true, x0, true);  // Left edge (vertical, min x)
+            clippedPoints = clipPathEdge(clippedPoints, true, x0, true);  // Left edge (vertical, min x)
         }
 
-        // Replace the points in c with the clipped points
-        sc = c->point1;
-        while (sc) {
-            V4pPointP next = sc->next;
-            v4p_destroyPoint(sc);
-            sc = next;
+        // Replace the points in c with the clipped points, added from the last one since
+        // points are listed from the last added one
+        while (c->point1) {
+            v4p_destroyPointFrom(c, c->point1);
+        }
+        ClipPointP reversed = NULL;
+        while (clippedPoints) {
+            ClipPointP next = clippedPoints->next;
+            clippedPoints->next = reversed;
+            reversed = clippedPoints;
+            clippedPoints = next;
         }
-        c->point1 = clippedPoints;
+        for (ClipPointP cp = reversed; cp; cp = cp->next) v4p_addEllipseCenter(c, cp->x, cp->y, cp->a, cp->b);
+        destroyClipPoints(reversed);
         c->miny = V4P_NIL;  // Invalidate computed boundaries
         v4p_changed(c);
     }
@@ -10,7 +10,7 @@ void v4p_debugPolygonPoints(V4pPointP points) {
     while (pt) {
         v4p_debug(pt->a > 0 ? "Point %d: (%d,%d) center of ellipsis (%d,%d)\n" : "Point %d: (%d, %d)\n", point_idx++,
                   pt->x, pt->y, pt->a, pt->b);
-        pt = pt->next;
+        pt = v4p_nextPoint(pt);
     }
 }
 
@@ -0,0 +1,31 @@
+#include "g4pi.h"
+#include "g4p.h"
+#include <stdlib.h>
+
+// No input device in headless mode.
+// The game loop stops after $V4P_MEM_FRAMES frames (never if unset).
+static long maxFrames = 0;
+static long frames = 0;
+
+// Initialize the game engine
+void g4pi_init() {
+    const char* s = getenv("V4P_MEM_FRAMES");
+    maxFrames = s ? atol(s) : 0;
+    frames = 0;
+}
+
+// Cleanup the game engine
+void g4pi_destroy() {
+}
+
+// Poll a single event from the event buffer
+bool g4p_pollEvent(G4pEvent* event) {
+    (void) event;  // No events
+    return false;
+}
+
+// poll user events
+int g4pi_pollEvents() {
+    frames++;
+    return (maxFrames > 0 && frames >= maxFrames);
+}
@@ -9,7 +9,7 @@
 #define CRASH do { *(volatile int*) 0 = 0; } while(0)  // Force immediate crash
 
 // Global collision points system
-static CollisionPointsSystem g4p_collision_points_system = {NULL, 0, NULL, NULL};
+static CollisionPointsSystem g4p_collision_points_system = {NULL, 0, NULL, NULL, NULL};
 
 // Hash function to generate a key for polygon pair (p1, p2)
 // Uses polygon IDs for more efficient and stable hashing
@@ -50,6 +50,11 @@ void g4p_initCollisions(size_t table_size) {
         v4p_error("Failed to create collision data QuickHeap\n");
         CRASH;
     }
+    g4p_collision_points_system.list_heap = QuickHeapNewFor(struct sList);
+    if (!g4p_collision_points_system.list_heap) {
+        v4p_error("Failed to create collision list QuickHeap\n");
+        CRASH;
+    }
 
     v4p_trace(COLLISION, "Collision points system initialized with table size %zu\n", table_size);
 }
@@ -58,7 +63,7 @@ void g4p_initCollisions(size_t table_size) {
 void g4p_resetCollisions() {
     // Clear all entries in the QuickTable and free associated memory
     // Using QuickHeap for data storage and QuickHeapReset for efficient clearing
-    QuickTableResetAndFree(g4p_collision_points_system.table);
+    QuickTableResetAndFree(g4p_collision_points_system.table, g4p_collision_points_system.list_heap);
     
     // Reset the QuickHeap to clear all collision data efficiently
     QuickHeapReset(g4p_collision_points_system.data_heap);
@@ -110,9 +115,11 @@ void g4p_destroyCollisions() {
     g4p_collision_points_system.callback = NULL;
     v4p_trace(COLLISION, "Collision points system destroyed\n");
     
-    // Clean up the QuickHeap
+    // Clean up the QuickHeaps
     QuickHeapDestroy(g4p_collision_points_system.data_heap);
     g4p_collision_points_system.data_heap = NULL;
+    QuickHeapDestroy(g4p_collision_points_system.list_heap);
+    g4p_collision_points_system.list_heap = NULL;
 }
 
 // Set callback function for collision point finalization
@@ -196,7 +203,7 @@ void g4p_addCollisionPoint(V4pPolygonP p1, V4pPolygonP p2, V4pCoord x, V4pCoord
     }
     
     // No existing data found, create new entry
-    List new_list = ListNew();
+    List new_list = ListNewIn(g4p_collision_points_system.list_heap);
     if (!new_list) {
         CRASH;
     }
@@ -28,6 +28,7 @@ typedef struct collision_points_system_s {
     QuickTable table;     // QuickTable to access collision point data
     size_t table_size;   // Size of the QuickTable
     QuickHeap data_heap;  // QuickHeap for efficient collision data storage
+    QuickHeap list_heap;  // QuickHeap for the List elements of the table
     G4pCollisionCallback callback; // Callback function for finalization
 } CollisionPointsSystem;
 
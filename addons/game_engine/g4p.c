@@ -94,13 +94,14 @@ int g4p_main(int argc, char* argv[]) {
         // Initialize collision points system with a reasonable table size
         g4p_initCollisions(64);
 
-        // Set default callback
-        v4p_setCollisionCallback(g4p_onCollide);
-
         // Init call-back with parsed parameters
         if (g4p_onInit(quality, fullscreen))
             return failure;
 
+        // Set default callback, unless set by the init call-back
+        if (! v4p_getCollisionCallback())
+            v4p_setCollisionCallback(g4p_onCollide);
+
         lastTickTime = v4p_getTicks();
         while (! rc) {  // main game loop
             // Get current time and calculate delta since last tick
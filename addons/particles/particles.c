@@ -37,7 +37,10 @@ ParticleSystem* particles_create(int max_particles, V4pPolygonP prototype) {
     
     // Allocate particle array
     system->particles = (Particle*)malloc(max_particles * sizeof(Particle));
-    if (!system->particles) {
+    system->jobs = (V4pTransformJob*)malloc(max_particles * sizeof(V4pTransformJob));
+    if (!system->particles || !system->jobs) {
+        free(system->particles);
+        free(system->jobs);
         free(system);
         return NULL;
     }
@@ -81,6 +84,7 @@ void particles_destroy(ParticleSystem* system) {
     
     // Free memory
     free(system->particles);
+    free(system->jobs);
     free(system);
 }
 
@@ -153,7 +157,7 @@ void particles_emit(ParticleSystem* system, float x, float y, float angle) {
     particle->scale = 1.0f;
     particle->active = true;
     
-    // Transform the particle - computeCosSin/v4p_transform will handle angle wrapping
+    // Transform the particle - v4p_transform will handle angle wrapping
     int v4p_angle = (int)(particle->rotation_angle * 512.0f / 360.0f);
     v4p_transform(particle->poly, x, y, (uint16_t)v4p_angle, 0, 256, 256);
 
@@ -163,6 +167,7 @@ void particles_emit(ParticleSystem* system, float x, float y, float angle) {
 // Update all particles in the system
 void particles_iterate(ParticleSystem* system, int32_t deltaTime) {
     if (!system) return;
+    int jobs = 0;
     
     for (int i = 0; i < system->max_particles; i++) {
         Particle* particle = &system->particles[i];
@@ -184,15 +189,13 @@ void particles_iterate(ParticleSystem* system, int32_t deltaTime) {
         particle->speed += particle->acceleration * deltaTime;
         
         // Update position based on speed and move angle
-        int sina, cosa;
-        // Convert to V4P angle format - computeCosSin will handle wrapping via bitmasking
+        QuickRotation move;
+        // Convert to V4P angle format - computeRotation will handle wrapping via bitmasking
         int v4p_move_angle = (int)(particle->move_angle * 512.0f / 360.0f);
-        computeCosSin(v4p_move_angle);
-        sina = lwmSina;
-        cosa = lwmCosa;
+        computeRotation(&move, (uint16_t) v4p_move_angle);
         
-        particle->x += (sina / 256.0f) * particle->speed * deltaTime;
-        particle->y -= (cosa / 256.0f) * particle->speed * deltaTime;
+        particle->x += (move.sina / 256.0f) * particle->speed * deltaTime;
+        particle->y -= (move.cosa / 256.0f) * particle->speed * deltaTime;
         
         // Update rotation angle separately from movement angle (frame-rate independent)
         particle->rotation_angle += particle->rotation_speed * deltaTime;
@@ -203,12 +206,10 @@ void particles_iterate(ParticleSystem* system, int32_t deltaTime) {
         // Transform the particle using double modulo for proper V4P angle wrapping
         int scale_int = (int)(particle->scale * 256.0f);
         int v4p_angle = ((int)(particle->rotation_angle * 512.0f / 360.0f) % 512 + 512) % 512;
-        v4p_transform(particle->poly, 
-                      particle->x, 
-                      particle->y, 
-                      (uint16_t)v4p_angle, 
-                      0, 
-                      scale_int, 
-                      scale_int);
+        V4pTransformJob job = { particle->poly, particle->x, particle->y, v4p_angle, 0, scale_int, scale_int };
+        system->jobs[jobs++] = job;
     }
+
+    // Transform all moving particles at once
+    v4p_transformBatch(system->jobs, jobs);
 }
\ No newline at end of file
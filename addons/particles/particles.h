@@ -22,6 +22,7 @@ typedef struct Particle {
 // Particle system structure
 typedef struct {
     Particle* particles;             // Array of all particles (pre-allocated)
+    V4pTransformJob* jobs;           // Particle transforms of an iteration (see v4p_transformBatch)
     V4pPolygonP prototype;             // Prototype polygon to clone
     int max_particles;                 // Maximum number of particles
     int active_particles;              // Currently active particles
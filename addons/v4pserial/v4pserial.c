@@ -101,7 +101,7 @@ char* v4p_encodePoints(V4pPolygonP p, int scale) {
         if (pm && m == s1) {
             s[l++] = '.';
             pm = NULL;
-            s1 = m->next;
+            s1 = v4p_nextPoint(m);
             m = s1;
         } else {
             for (i = 0; i <= 1; i++) {
@@ -114,7 +114,7 @@ char* v4p_encodePoints(V4pPolygonP p, int scale) {
                 s[l++] = t[(v >> 4) & 15];
             }
             pm = m;
-            m = m->next;
+            m = v4p_nextPoint(m);
         }
         if (l % 32 >= 28) {
             s = (char*) realloc(s, (64 + l - l % 32) * sizeof(char));
@@ -202,13 +202,74 @@ static int parse_coords(const char* s, int* j, float* p1, float* p2) {
     return count;
 }
 
+// Position along an SVG path being decoded
+typedef struct {
+    float x, y;  // current point (where the current curve starts)
+    int pair;  // coordinate pairs read along the current curve
+    float cx, cy;  // last control point, mirrored by a smooth curve (S, s, T, t)
+    char curve;  // command of the former curve, 0 after a line or a move
+} V4pSVGPen;
+
+// Add a Bezier control point at SVG coordinates
+static void v4p_svgControlPoint(V4pPolygonP p, V4pSVGPen* pen, float x, float y, float scale) {
+    v4p_addControlPoint(p, (V4pCoord) roundf(x * scale), (V4pCoord) roundf(y * scale));
+    pen->cx = x;
+    pen->cy = y;
+}
+
+// Apply the coordinates read after an SVG path command: a pair, or a single one for h and v
+// Curves take several pairs: their control points before their end point, relative ones being
+// relative to the curve start. Returns true once a path point is added.
+static bool v4p_svgCoords(V4pPolygonP p, V4pSVGPen* pen, char cmd, bool relative, int count, float c1, float c2,
+                          float scale) {
+    char lower = cmd | 0x20;
+    float x = pen->x, y = pen->y;
+
+    if (lower == 'h' || lower == 'v') {
+        if (count < 1) return false;
+        if (lower == 'h')
+            x = relative ? x + c1 : c1;
+        else
+            y = relative ? y + c1 : c1;
+    } else {
+        if (count < 2) return false;  // need both coords for all other commands
+        x = relative ? x + c1 : c1;
+        y = relative ? y + c2 : c2;
+    }
+
+    if (lower == 'c' || lower == 's' || lower == 'q' || lower == 't') {
+        int controls = lower == 'c' ? 2 : (lower == 't' ? 0 : 1);
+        if (pen->pair == 0 && (lower == 's' || lower == 't')) {  // first control point mirrored
+            bool smooth = (lower == 's') ? (pen->curve == 'c' || pen->curve == 's')
+                                         : (pen->curve == 'q' || pen->curve == 't');
+            v4p_svgControlPoint(p, pen, smooth ? 2 * pen->x - pen->cx : pen->x, smooth ? 2 * pen->y - pen->cy : pen->y,
+                                scale);
+        }
+        if (pen->pair++ < controls) {
+            v4p_svgControlPoint(p, pen, x, y, scale);
+            return false;
+        }
+        pen->pair = 0;
+        pen->curve = lower;
+    } else {
+        pen->curve = 0;
+    }
+
+    v4p_addPoint(p, (V4pCoord) roundf(x * scale), (V4pCoord) roundf(y * scale));
+    pen->x = x;
+    pen->y = y;
+    return true;
+}
+
+// add the points of an SVG path to a polygon, curves being bent by Bezier control points
 V4pPolygonP v4p_decodeSVGPath(V4pPolygonP p, const char* s, float scale) {
     int j;
     bool knowFirstPoint = false, nextIsRelative = false;
     char cmd = 0;
     enum e_status { INIT, MOVE, LINE, NEXT } status = INIT;
     float param_1, param_2;
-    float xs = 0, ys = 0, xs1 = 0, ys1 = 0;
+    float xs1 = 0, ys1 = 0;
+    V4pSVGPen pen = { 0 };
 
     for (j = 0; s[j]; j++) {
         char c = s[j];
@@ -224,32 +285,11 @@ V4pPolygonP v4p_decodeSVGPath(V4pPolygonP p, const char* s, float scale) {
                     j--;
 
                     // Apply coordinates according to current command
-                    if (cmd == 'h' || cmd == 'H') {
-                        if (nextIsRelative)
-                            xs += param_1;
-                        else
-                            xs = param_1;
-                    } else if (cmd == 'v' || cmd == 'V') {
-                        if (nextIsRelative)
-                            ys += param_1;
-                        else
-                            ys = param_1;
-                    } else {
-                        if (count < 2) continue;  // need both coords for all other commands
-                        if (nextIsRelative) {
-                            xs += param_1;
-                            ys += param_2;
-                        } else {
-                            xs = param_1;
-                            ys = param_2;
-                        }
-                    }
-
-                    v4p_addPoint(p, (V4pCoord) roundf(xs * scale), (V4pCoord) roundf(ys * scale));
+                    if (! v4p_svgCoords(p, &pen, cmd, nextIsRelative, count, param_1, param_2, scale)) continue;
 
                     if (! knowFirstPoint) {
-                        xs1 = xs;
-                        ys1 = ys;
+                        xs1 = pen.x;
+                        ys1 = pen.y;
                         knowFirstPoint = true;
                     }
                     continue;  // stay in NEXT, consume more implicit coords
@@ -267,28 +307,32 @@ V4pPolygonP v4p_decodeSVGPath(V4pPolygonP p, const char* s, float scale) {
                     cmd = 'l';
                 else if (cmd == 'M')
                     cmd = 'L';
+                pen.pair = 0;
 
                 if (c == 'L' || c == 'l') {
                     status = LINE;
                 } else if (c == 'M' || c == 'm') {
                     status = MOVE;
-                } else if (c == 'C' || c == 'c' || c == 'Q' || c == 'q') {
+                } else if (c == 'C' || c == 'c' || c == 'S' || c == 's' || c == 'Q' || c == 'q' || c == 'T'
+                           || c == 't') {
                     status = LINE;
-                }  // curves: endpoint only
-                else if (c == 'h' || c == 'H' || c == 'v' || c == 'V') {
+                } else if (c == 'h' || c == 'H' || c == 'v' || c == 'V') {
                     status = LINE;
                 } else if (c == 'z' || c == 'Z') {
                     if (knowFirstPoint) {
                         v4p_addPoint(p, (V4pCoord) roundf(xs1 * scale), (V4pCoord) roundf(ys1 * scale));
+                        pen.x = xs1;
+                        pen.y = ys1;
                         knowFirstPoint = false;
                     }
+                    pen.curve = 0;
                     // After z, implicit next command is M from current position.
                     // Reset cmd so stale h/v/l don't misinterpret any following chars.
                     cmd = 0;
                     status = INIT;  // not NEXT — z consumes no coordinates
                 }
 
-                nextIsRelative = (c == 'm' || c == 'l' || c == 'h' || c == 'v');
+                nextIsRelative = (c >= 'a' && c <= 'z');
                 break;
 
             case LINE:
@@ -300,37 +344,15 @@ V4pPolygonP v4p_decodeSVGPath(V4pPolygonP p, const char* s, float scale) {
                     }
 
                     // For h/v only one coordinate is valid
-                    if (cmd == 'h' || cmd == 'H') {
-                        if (count < 1) continue;
-                        if (nextIsRelative)
-                            xs += param_1;
-                        else
-                            xs = param_1;
-                    } else if (cmd == 'v' || cmd == 'V') {
-                        if (count < 1) continue;
-                        if (nextIsRelative)
-                            ys += param_1;
-                        else
-                            ys = param_1;
-                    } else {
-                        if (count < 2) continue;
-                        if (nextIsRelative) {
-                            xs += param_1;
-                            ys += param_2;
-                        } else {
-                            xs = param_1;
-                            ys = param_2;
-                        }
-                    }
-
-                    v4p_addPoint(p, (V4pCoord) roundf(xs * scale), (V4pCoord) roundf(ys * scale));
+                    if (count < ((cmd | 0x20) == 'h' || (cmd | 0x20) == 'v' ? 1 : 2)) continue;
+                    status = NEXT;  // further coordinates, as long as numbers follow
+                    if (! v4p_svgCoords(p, &pen, cmd, nextIsRelative, count, param_1, param_2, scale)) break;
 
                     if (! knowFirstPoint) {
-                        xs1 = xs;
-                        ys1 = ys;
+                        xs1 = pen.x;
+                        ys1 = pen.y;
                         knowFirstPoint = true;
                     }
-                    status = NEXT;
                     break;
                 }
         }  // switch
@@ -31,9 +31,9 @@ typedef struct v4pi_context_s {
 // Global variables
 V4piContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth = V4P_DEFAULT_SCREEN_WIDTH;
-V4pCoord v4p_displayHeight = V4P_DEFAULT_SCREEN_HEIGHT;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth = V4P_DEFAULT_SCREEN_WIDTH;
+V4P_TLS V4pCoord v4p_displayHeight = V4P_DEFAULT_SCREEN_HEIGHT;
 
 static uint32_t t1;
 static uint32_t laps[4] = { 0, 0, 0, 0 };
@@ -91,9 +91,7 @@ int v4pi_start() {
     // remember start time
     t1 = v4p_getTicks();
 
-    // Clear bitmap to transparent black
-    size_t bitmap_size = v4pi_context->width * v4pi_context->height * sizeof(uint32_t);
-    memset(v4pi_context->bitmap, 0, bitmap_size);
+    // The bitmap is not cleared: every row is drawn or kept as is (see V4PI_PARTIAL)
     return success;
 }
 
@@ -126,6 +124,11 @@ int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
     return success;
 }
 
+// Nothing to do: the whole bitmap is transferred at v4pi_end()
+int v4pi_damage(V4pCoord y0, V4pCoord y1) {
+    return success;
+}
+
 // Finalize rendering and display bitmap
 int v4pi_end() {
     static int j = 0;
@@ -40,9 +40,9 @@ V4piContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth;
-V4pCoord v4p_displayHeight;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
 
 // Canvas context for 2D rendering
 EMSCRIPTEN_WEBGL_CONTEXT_HANDLE canvas_context = 0;
@@ -16,8 +16,8 @@
 
 
 // V4P display context variables
-V4pCoord v4p_displayWidth = 640;
-V4pCoord v4p_displayHeight = 480;
+V4P_TLS V4pCoord v4p_displayWidth = 640;
+V4P_TLS V4pCoord v4p_displayHeight = 480;
 
 // A display context for DOM backend
 typedef struct v4pi_context_s {
@@ -31,7 +31,7 @@ V4piContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
 
 // Initialize the DOM backend
 int v4pi_init(int quality, bool fullscreen) {
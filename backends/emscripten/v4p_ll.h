@@ -7,3 +7,10 @@ typedef int32_t V4pCoord;
 
 #define failure 1
 #define success 0
+
+// Thread-local storage of current contexts (one context per thread)
+#ifdef __EMSCRIPTEN_PTHREADS__
+    #define V4P_TLS __thread
+#else
+    #define V4P_TLS
+#endif
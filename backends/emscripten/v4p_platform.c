@@ -11,6 +11,10 @@ int32_t v4p_getTicks() {
     return (int32_t) (emscripten_get_now() - t0);
 }
 
+int64_t v4p_getNanos() {
+    return (int64_t) (emscripten_get_now() * 1000000.0);
+}
+
 // pause execution
 void v4p_delay(int32_t d) {
     // Emscripten async delay using emscripten_sleep requires ASYNCIFY support
@@ -6,7 +6,15 @@
 
 #define v4p_malloc malloc
 #define v4p_free free
+#define v4p_realloc realloc
 #define v4p_memset memset
 #define v4p_assert(expression, message) assert(expression)
 int32_t v4p_getTicks();
+int64_t v4p_getNanos();  // monotonic clock in nanoseconds (render stats)
 void v4p_delay(int32_t d);
+
+// Run f(arg, i) for i in [0, n), serially on this platform
+#define v4p_parallelFor(N, F, ARG, THREADS) \
+    do { \
+        for (int _iXYZ = 0; _iXYZ < (N); _iXYZ++) (F)((ARG), _iXYZ); \
+    } while (0)
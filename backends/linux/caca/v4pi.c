@@ -36,9 +36,9 @@ V4piContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth;
-V4pCoord v4p_displayHeight;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
 
 // Function to get the current display for event handling
 static void* v4pi_get_current_display() {
@@ -64,12 +64,8 @@ static uint16_t v4p_color_to_caca_argb16(V4pColor c) {
 }
 
 // prepare things before V4P engine scanline loop
+// The framebuffer is not cleared: every row is drawn or kept as is (see V4PI_PARTIAL)
 int v4pi_start() {
-    // Clear the framebuffer if it exists
-    if (v4pi_context->framebuffer) {
-        memset(v4pi_context->framebuffer, 0, v4pi_context->height * v4pi_context->pitch * sizeof(uint8_t));
-    }
-    
     return success;
 }
 
@@ -112,6 +108,11 @@ int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
     return success;
 }
 
+// Nothing to do: the whole framebuffer is dithered at v4pi_end()
+int v4pi_damage(V4pCoord y0, V4pCoord y1) {
+    return success;
+}
+
 // Prepare things before the very first graphic rendering
 int v4pi_init(int quality, bool fullscreen) {
     // Initialize libcaca
@@ -60,11 +60,11 @@ typedef v4pi_context_s DRMContext;
 static v4pi_context_s drm_context = { 0 };
 
 V4piContextP v4pi_defaultContext = NULL;
-V4piContextP v4pi_context = NULL;
+V4P_TLS V4piContextP v4pi_context = NULL;
 
 // Display dimensions
-V4pCoord v4p_displayWidth = 0;
-V4pCoord v4p_displayHeight = 0;
+V4P_TLS V4pCoord v4p_displayWidth = 0;
+V4P_TLS V4pCoord v4p_displayHeight = 0;
 
 // Error handling macro
 #define CHECK_DRM_ERROR(cond, msg) \
@@ -458,6 +458,33 @@ int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
     return success;
 }
 
+// Nothing to do: slices are written straight into the framebuffer, which keeps other rows
+int v4pi_damage(V4pCoord y0, V4pCoord y1) {
+    return success;
+}
+
+// Draw a whole scanline
+int v4pi_spans(V4pCoord y, const V4pSpan* spans, int n) {
+    static uint32_t palette32[256];  // palette converted to XRGB8888
+    static bool paletteReady = false;
+    if (! v4pi_context || ! v4pi_context->fb_memory || y < 0 || y >= (V4pCoord) v4pi_context->fb_height
+        || (n && spans[n - 1].x1 > (V4pCoord) v4pi_context->fb_width)) {
+        return failure;
+    }
+    if (! paletteReady) {
+        for (int i = 0; i < 256; i++)
+            palette32[i] = ((uint32_t) V4P_PALETTE_R(i) << 16) | ((uint32_t) V4P_PALETTE_G(i) << 8) | V4P_PALETTE_B(i);
+        paletteReady = true;
+    }
+
+    uint32_t* pixel = (uint32_t*) (v4pi_context->fb_memory + y * v4pi_context->fb_stride);
+    for (const V4pSpan* end = spans + n; spans < end; spans++) {
+        uint32_t color = palette32[spans->c];
+        for (V4pCoord x = spans->x0; x < spans->x1; x++) pixel[x] = color;
+    }
+    return success;
+}
+
 int v4pi_end() {
     // For dumb buffers, changes are immediately visible
     return success;
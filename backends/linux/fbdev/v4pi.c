@@ -38,6 +38,9 @@ typedef struct v4pi_context_s {
  */
 static struct fb_cmap palette;
 
+// Same palette packed as 24/32 bits BGR(A) pixels
+static uint32_t palette32[256];
+
 static void init_palette() {
     palette.start = 0;
     palette.len = 256;
@@ -55,6 +58,7 @@ static void init_palette() {
         palette.red[i] = V4P_PALETTE_R(i);
         palette.green[i] = V4P_PALETTE_G(i);
         palette.blue[i] = V4P_PALETTE_B(i);
+        palette32[i] = ((uint32_t) V4P_PALETTE_R(i) << 16) | ((uint32_t) V4P_PALETTE_G(i) << 8) | V4P_PALETTE_B(i);
     }
 }
 
@@ -75,11 +79,11 @@ FbdevContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth;
-V4pCoord v4p_displayHeight;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
 // private properties of current context
-static unsigned char* currentBuffer;
+static V4P_TLS unsigned char* currentBuffer;
 static int iBuffer;
 
 // Metrics stuff
@@ -138,6 +142,38 @@ int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
     return success;
 }
 
+// Nothing to do: slices are written straight into the framebuffer, which keeps other rows
+int v4pi_damage(V4pCoord y0, V4pCoord y1) {
+    return success;
+}
+
+// Draw a whole scanline
+int v4pi_spans(V4pCoord y, const V4pSpan* spans, int n) {
+    unsigned char* row = &currentBuffer[y * v4pi_context->line_length];
+    const V4pSpan* end = spans + n;
+
+    if (v4pi_context->vinfo.bits_per_pixel == 8) {
+        for (; spans < end; spans++) memset(row + spans->x0, spans->c, spans->x1 - spans->x0);
+    } else if (v4pi_context->bpp == 4) {
+        uint32_t* dest = (uint32_t*) row;
+        for (; spans < end; spans++) {
+            uint32_t color = palette32[spans->c];
+            for (V4pCoord x = spans->x0; x < spans->x1; x++) dest[x] = color;
+        }
+    } else {
+        for (; spans < end; spans++) {
+            uint32_t color = palette32[spans->c];
+            unsigned char* dest = row + spans->x0 * 3;
+            for (V4pCoord x = spans->x0; x < spans->x1; x++) {
+                *dest++ = color;  // Blue component
+                *dest++ = color >> 8;  // Green component
+                *dest++ = color >> 16;  // Red component
+            }
+        }
+    }
+    return success;
+}
+
 // Prepare things before the very first graphic rendering
 int v4pi_init(int quality, bool fullscreen) {
     // Initialize palette
@@ -0,0 +1,215 @@
+/**
+ * V4P Implementation for headless in-memory rendering
+ *
+ * No display device is needed: slices are written into a plain memory buffer,
+ * either allocated by the backend or supplied by the caller (see v4pi_mem.h).
+ * Useful for server-side rasterization, golden-image checks and benchmarks.
+ */
+#include "v4pi.h"
+#include "v4pi_mem.h"
+#include "v4p_platform.h"
+#include "v4p_trace.h"
+#include "v4p_color.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Default buffer width & heigth
+const V4pCoord V4P_DEFAULT_SCREEN_WIDTH = 640, V4P_DEFAULT_SCREEN_HEIGHT = 480;
+
+// A display context
+typedef struct v4pi_context_s {
+    uint8_t* pixels;  // Pixel buffer
+    unsigned int width;
+    unsigned int height;
+    int stride;  // Bytes per row
+    int bpp;  // Bits per pixel (8 or 32)
+    bool owned;  // Is the buffer allocated by the backend?
+    V4pCoord damageMinY, damageMaxY;  // Rows drawn by last frame
+} V4piContext;
+
+// Global variable hosting the default V4P context
+V4piContext v4pi_defaultContextSingleton;
+V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
+
+// Variables hosting current context and related properties
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
+// private properties of current context
+static V4P_TLS uint8_t* currentBuffer;
+static V4P_TLS int currentStride;
+
+// Palette converted once for 32 bits buffers (XRGB8888)
+static uint32_t palette32[256];
+
+static void init_palette() {
+    for (int i = 0; i < 256; i++) {
+        palette32[i] = ((uint32_t) V4P_PALETTE_R(i) << 16) | ((uint32_t) V4P_PALETTE_G(i) << 8) | V4P_PALETTE_B(i);
+    }
+}
+
+// prepare things before V4P engine scanline loop
+int v4pi_start() {
+    v4pi_context->damageMinY = v4pi_context->damageMaxY = 0;
+    return currentBuffer ? success : failure;
+}
+
+// finalize things after V4P engine scanline loop
+int v4pi_end() {
+    return success;
+}
+
+// Draw an horizontal video slice with color 'c'
+int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
+    int l = x1 - x0;
+    if (l <= 0)
+        return success;
+
+    uint8_t* row = currentBuffer + y * currentStride;
+    if (v4pi_context->bpp == 8) {
+        memset(row + x0, c, l);
+    } else {
+        uint32_t* dest = (uint32_t*) row + x0;
+        uint32_t color = palette32[c];
+        while (l--) *dest++ = color;
+    }
+    return success;
+}
+
+// Remember the rows drawn by current frame
+int v4pi_damage(V4pCoord y0, V4pCoord y1) {
+    V4piContextP c = v4pi_context;
+    if (c->damageMinY == c->damageMaxY) {
+        c->damageMinY = y0;
+        c->damageMaxY = y1;
+    } else {
+        if (y0 < c->damageMinY) c->damageMinY = y0;
+        if (y1 > c->damageMaxY) c->damageMaxY = y1;
+    }
+    return success;
+}
+
+// Draw a whole scanline
+int v4pi_spans(V4pCoord y, const V4pSpan* spans, int n) {
+    uint8_t* row = currentBuffer + y * currentStride;
+    const V4pSpan* end = spans + n;
+    if (v4pi_context->bpp == 8) {
+        for (; spans < end; spans++) memset(row + spans->x0, spans->c, spans->x1 - spans->x0);
+    } else {
+        uint32_t* dest = (uint32_t*) row;
+        for (; spans < end; spans++) {
+            uint32_t color = palette32[spans->c];
+            for (V4pCoord x = spans->x0; x < spans->x1; x++) dest[x] = color;
+        }
+    }
+    return success;
+}
+
+// Prepare things before the very first graphic rendering
+int v4pi_init(int quality, bool fullscreen) {
+    (void) fullscreen;  // No window
+    int width = V4P_DEFAULT_SCREEN_WIDTH * 2 / (3 - quality);
+    int height = V4P_DEFAULT_SCREEN_HEIGHT * 2 / (3 - quality);
+
+    init_palette();
+
+    v4pi_defaultContextSingleton.pixels = malloc(width * height);
+    if (! v4pi_defaultContextSingleton.pixels) {
+        v4p_error("v4pi_init failed, cannot allocate %dx%d buffer\n", width, height);
+        return failure;
+    }
+    memset(v4pi_defaultContextSingleton.pixels, 0, width * height);
+    v4pi_defaultContextSingleton.width = width;
+    v4pi_defaultContextSingleton.height = height;
+    v4pi_defaultContextSingleton.stride = width;
+    v4pi_defaultContextSingleton.bpp = 8;
+    v4pi_defaultContextSingleton.owned = true;
+    v4pi_defaultContextSingleton.damageMinY = v4pi_defaultContextSingleton.damageMaxY = 0;
+
+    // The default context holds the main buffer
+    v4pi_setContext(v4pi_defaultContext);
+
+    return success;
+}
+
+// Create a display context rendering into a caller-supplied buffer
+V4piContextP v4pi_newBufferContext(void* pixels, int width, int height, int stride, int bitsPerPixel) {
+    if (! pixels || (bitsPerPixel != 8 && bitsPerPixel != 32))
+        return NULL;
+
+    V4piContextP c = (V4piContextP) malloc(sizeof(V4piContext));
+    if (! c)
+        return NULL;
+
+    c->pixels = pixels;
+    c->width = width;
+    c->height = height;
+    c->bpp = bitsPerPixel;
+    c->stride = stride ? stride : width * (bitsPerPixel / 8);
+    c->owned = false;
+    c->damageMinY = c->damageMaxY = 0;
+    return c;
+}
+
+// Create a new buffer-like V4P context
+V4piContextP v4pi_newContext(int width, int height) {
+    uint8_t* pixels = malloc(width * height);
+    if (! pixels)
+        return NULL;
+
+    V4piContextP c = v4pi_newBufferContext(pixels, width, height, width, 8);
+    if (! c) {
+        free(pixels);
+        return NULL;
+    }
+    memset(pixels, 0, width * height);
+    c->owned = true;
+    return c;
+}
+
+// Get the pixel buffer of a context
+void* v4pi_getBuffer(V4piContextP c, int* stride, int* bitsPerPixel) {
+    if (stride) *stride = c->stride;
+    if (bitsPerPixel) *bitsPerPixel = c->bpp;
+    return c->pixels;
+}
+
+// Get the rows drawn by the last frame of a context
+void v4pi_getDamage(V4piContextP c, int* y0, int* y1) {
+    *y0 = c->damageMinY;
+    *y1 = c->damageMaxY;
+}
+
+// free a V4P context
+void v4pi_destroyContext(V4piContextP c) {
+    if (! c || c == v4pi_defaultContext)
+        return;
+
+    if (c->owned)
+        free(c->pixels);
+    free(c);
+
+    // One can't let a pointer to a freed context.
+    if (v4pi_context == c)
+        v4pi_setContext(v4pi_defaultContext);
+}
+
+// Change the current V4P context
+V4piContextP v4pi_setContext(V4piContextP c) {
+    v4pi_context = c;
+    v4p_displayWidth = c->width;
+    v4p_displayHeight = c->height;
+    currentBuffer = c->pixels;
+    currentStride = c->stride;
+    return c;
+}
+
+// clean things before quitting
+void v4pi_destroy() {
+    if (v4pi_defaultContextSingleton.owned)
+        free(v4pi_defaultContextSingleton.pixels);
+    v4pi_defaultContextSingleton.pixels = NULL;
+    v4pi_context = v4pi_defaultContext;
+    currentBuffer = NULL;
+}
@@ -0,0 +1,22 @@
+#ifndef V4PI_MEM_H
+#define V4PI_MEM_H
+/**
+ * V4P In-Memory Implementation I/F
+ * Extra functions of the headless "mem" backend
+ */
+#include "v4pi.h"
+
+/** Create a display context rendering into a caller-supplied pixel buffer
+ *  'stride' is the byte offset between two rows (0 = packed rows)
+ *  'bitsPerPixel' is 8 (palette indices) or 32 (XRGB8888)
+ *  The buffer is not owned by the context */
+V4piContextP v4pi_newBufferContext(void* pixels, int width, int height, int stride, int bitsPerPixel);
+
+/** Get the pixel buffer of a context, with its stride and depth */
+void* v4pi_getBuffer(V4piContextP context, int* stride, int* bitsPerPixel);
+
+/** Get the rows [y0, y1) drawn by the last frame of a context, y0 == y1 if none
+ *  Rows out of this range kept their pixels (see v4p_setPartialRefresh) */
+void v4pi_getDamage(V4piContextP context, int* y0, int* y1);
+
+#endif  // V4PI_MEM_H
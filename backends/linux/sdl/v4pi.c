@@ -57,11 +57,11 @@ V4piContext v4pi_defaultContextSingleton;
 V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth;
-V4pCoord v4p_displayHeight;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
 // private properties of current context
-static Uint8* currentBuffer;
+static V4P_TLS Uint8* currentBuffer;
 static int iBuffer;
 
 // Metrics stuff
@@ -26,9 +26,9 @@ V4piContext v4pi_defaultContextSingleton;
 const V4piContextP v4pi_defaultContext = &v4pi_defaultContextSingleton;
 
 // Variables hosting current context and related properties
-V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
-V4pCoord v4p_displayWidth;
-V4pCoord v4p_displayHeight;
+V4P_TLS V4piContextP v4pi_context = &v4pi_defaultContextSingleton;
+V4P_TLS V4pCoord v4p_displayWidth;
+V4P_TLS V4pCoord v4p_displayHeight;
 
 // prepare things before V4P engine scanline loop
 int v4pi_start() {
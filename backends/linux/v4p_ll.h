@@ -7,3 +7,6 @@ typedef int32_t V4pCoord;
 
 #define failure 1
 #define success 0
+
+// Thread-local storage of current contexts (one context per thread)
+#define V4P_TLS __thread
@@ -32,6 +32,12 @@ int32_t v4p_getTicks() {
     return t;
 }
 
+int64_t v4p_getNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 void v4p_delay(int32_t d) {
     if (d <= 0) return;
     struct timespec req;
@@ -42,6 +48,95 @@ void v4p_delay(int32_t d) {
     }
 }
 
+#ifdef V4P_THREADS
+#include <pthread.h>
+
+// A pool of worker threads, created on demand and kept for next parallel loops
+#define V4P_MAX_THREADS 64
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;  // one parallel loop at a time
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;  // protects job state below
+static pthread_cond_t jobStart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobDone = PTHREAD_COND_INITIALIZER;
+static int workersNb = 0;
+static unsigned int jobId = 0;  // current parallel loop
+static void (*jobFunc)(void*, int);
+static void* jobArg;
+static int jobNb, jobNext, jobPending, jobSlots;
+
+// run iterations of parallel loop 'id' until exhaustion
+static void runIterations(unsigned int id) {
+    for (;;) {
+        pthread_mutex_lock(&jobLock);
+        if (jobId != id || jobNext >= jobNb) {
+            pthread_mutex_unlock(&jobLock);
+            return;
+        }
+        int i = jobNext++;
+        void (*f)(void*, int) = jobFunc;
+        void* arg = jobArg;
+        pthread_mutex_unlock(&jobLock);
+
+        f(arg, i);
+
+        pthread_mutex_lock(&jobLock);
+        if (--jobPending == 0) pthread_cond_signal(&jobDone);
+        pthread_mutex_unlock(&jobLock);
+    }
+}
+
+static void* worker(void* unused) {
+    (void) unused;
+    unsigned int seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&jobLock);
+        while (jobId == seen) pthread_cond_wait(&jobStart, &jobLock);
+        seen = jobId;
+        bool join = jobSlots > 0;
+        if (join) jobSlots--;
+        pthread_mutex_unlock(&jobLock);
+        if (join) runIterations(seen);
+    }
+    return NULL;
+}
+
+void v4p_parallelFor(int n, void (*f)(void* arg, int i), void* arg, int threads) {
+    if (threads > V4P_MAX_THREADS) threads = V4P_MAX_THREADS;
+    if (threads <= 1 || n <= 1 || pthread_mutex_trylock(&poolLock)) {
+        for (int i = 0; i < n; i++) f(arg, i);
+        return;
+    }
+
+    while (workersNb < threads - 1) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker, NULL)) break;
+        pthread_detach(thread);
+        workersNb++;
+    }
+
+    pthread_mutex_lock(&jobLock);
+    jobFunc = f;
+    jobArg = arg;
+    jobNb = jobPending = n;
+    jobNext = 0;
+    jobSlots = threads - 1;
+    unsigned int id = ++jobId;
+    pthread_cond_broadcast(&jobStart);
+    pthread_mutex_unlock(&jobLock);
+
+    runIterations(id);
+
+    pthread_mutex_lock(&jobLock);
+    while (jobPending) pthread_cond_wait(&jobDone, &jobLock);
+    pthread_mutex_unlock(&jobLock);
+    pthread_mutex_unlock(&poolLock);
+}
+#else
+void v4p_parallelFor(int n, void (*f)(void* arg, int i), void* arg, int threads) {
+    (void) threads;  // built without THREADS=1
+    for (int i = 0; i < n; i++) f(arg, i);
+}
+#endif
+
 void v4p_debug(char* formatString, ...) {
     va_list args;
     va_start(args, formatString);
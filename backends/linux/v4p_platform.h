@@ -6,7 +6,14 @@
 
 #define v4p_malloc malloc
 #define v4p_free free
+#define v4p_realloc realloc
 #define v4p_memset memset
 #define v4p_assert(expression, message) assert(expression)
 int32_t v4p_getTicks();
+int64_t v4p_getNanos();  // monotonic clock in nanoseconds (render stats)
 void v4p_delay(int32_t d);
+
+// Run f(arg, i) for i in [0, n) with up to 'threads' threads (the caller included)
+// Iterations run serially when built without V4P_THREADS (make THREADS=1)
+// or when another parallel loop is already running.
+void v4p_parallelFor(int n, void (*f)(void* arg, int i), void* arg, int threads);
@@ -11,4 +11,7 @@ typedef Int32 int32_t;
 
 #define failure 1
 #define success 0
+
+// No threads, no thread-local storage
+#define V4P_TLS
 #endif
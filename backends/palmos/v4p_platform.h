@@ -3,7 +3,15 @@
 #include <PalmOS.h>
 #define v4p_malloc malloc
 #define v4p_free free
+#define v4p_realloc realloc
 void v4p_memset(uint8_t* pdst, uint32_t numBytes, uint8_t value);
 #define v4p_assert(expression, message) assert(expression)
 #define v4p_getTicks() TimGetTicks()
+#define v4p_getNanos() ((int64_t) TimGetTicks() * (1000000000 / SysTicksPerSecond()))
 void v4p_delay(int32_t d);
+
+// Run f(arg, i) for i in [0, n), serially on this platform
+#define v4p_parallelFor(N, F, ARG, THREADS) \
+    do { \
+        for (int _iXYZ = 0; _iXYZ < (N); _iXYZ++) (F)((ARG), _iXYZ); \
+    } while (0)
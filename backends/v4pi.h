@@ -10,8 +10,8 @@ typedef struct v4pi_context_s* V4piContextP;
 /** default display context */
 extern V4piContextP v4pi_defaultContext;
 
-/** current display context */
-extern V4piContextP v4pi_context;
+/** current display context (per thread) */
+extern V4P_TLS V4piContextP v4pi_context;
 
 /** Initialize the implementation and a default context */
 int v4pi_init(int quality, bool fullscreen);
@@ -41,6 +41,23 @@ int v4pi_start();
 // Render Span/Slice
 int v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c);
 
+// A span: pixels from x0 (included) to x1 (excluded) of color c
+typedef struct v4p_span_s {
+    V4pCoord x0, x1;
+    V4pColor c;
+} V4pSpan;
+
+// Render a whole scanline at once (optional, backends built with -DV4PI_SPANS)
+// Spans are non-empty, ordered, adjacent, cover [0, v4p_displayWidth)
+// and two consecutive spans never share the same color.
+int v4pi_spans(V4pCoord y, const V4pSpan* spans, int n);
+
+// Tell rows [y0, y1) were drawn by the current frame (optional, backends built with -DV4PI_PARTIAL)
+// Such backends keep their pixels between frames, so that v4p_setPartialRefresh()
+// may redraw changed rows only. Called after the slices of these rows.
+// Rows looking the same as at previous frame are not even handed over to them.
+int v4pi_damage(V4pCoord y0, V4pCoord y1);
+
 // Finalize after last scanline rendered
 int v4pi_end();
 
@@ -0,0 +1,281 @@
+/**
+ * V4P synthetic rendering benchmark
+ *
+ * Renders parameterized scenes many times and reports, per scene:
+ *  - ns/frame and ns/scanline (wall clock around v4p_render())
+ *  - active edges per row (average number of edges crossed by a scanline)
+ *  - slices per frame (backend slices, or spans for backends drawing whole scanlines)
+ *  - a checksum of the last frame pixels, to spot rendering changes
+ *  - a per-phase breakdown when the library is built with STATS=1 or STATS=2
+ *
+ * Usage: bench/v4p_bench [-n count] [-f frames] [-s WxH] [-t threads] [-g cell] [-a] [-c] [scene...]
+ *   -n count   polygons per scene (default 200)
+ *   -f frames  rendered frames per scene (default 200)
+ *   -s WxH     display size (default 640x480)
+ *   -t threads rendering threads (default 1, needs a THREADS=1 build)
+ *   -g cell    index scenes in a grid of cell wide cells (see v4p_setSceneGrid)
+ *   -a         animate: move every polygon between frames
+ *   -c         cached: let rows drawn alike at last frame be skipped (by default, every frame draws all rows)
+ *   scene      polygons disks stroked subtree relative absolute zoomed world (default: all)
+ *
+ * Build with 'make bench' (BACKEND=mem for headless runs).
+ */
+#include "v4p.h"
+#include "v4pi.h"
+#define V4P_DEBUG_ADDON  // Define this to allow including _v4p.h (edges inspection)
+#include "_v4p.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Slices counting and pixels shadowing, see -Wl,--wrap=v4pi_slice in Makefile
+int __real_v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c);
+static unsigned long slices = 0;
+static uint8_t* shadow = NULL;  // Shadow copy of pixels (unchanged rows are not drawn again)
+
+int __wrap_v4pi_slice(V4pCoord y, V4pCoord x0, V4pCoord x1, V4pColor c) {
+    slices++;
+    if (shadow && x1 > x0) memset(shadow + y * v4p_displayWidth + x0, c, x1 - x0);
+    return __real_v4pi_slice(y, x0, x1, c);
+}
+
+#ifdef V4PI_SPANS
+// Same for backends drawing whole scanlines, see -Wl,--wrap=v4pi_spans in Makefile
+int __real_v4pi_spans(V4pCoord y, const V4pSpan* spans, int n);
+
+int __wrap_v4pi_spans(V4pCoord y, const V4pSpan* spans, int n) {
+    slices += n;
+    if (shadow) {
+        for (int i = 0; i < n; i++)
+            memset(shadow + y * v4p_displayWidth + spans[i].x0, spans[i].c, spans[i].x1 - spans[i].x0);
+    }
+    return __real_v4pi_spans(y, spans, n);
+}
+#endif
+
+// Deterministic pseudo random numbers so that checksums are stable
+static uint32_t seed = 1;
+static int rnd(int n) {
+    seed = seed * 1103515245 + 12345;
+    return (int) ((seed >> 8) % (uint32_t) n);
+}
+
+static int64_t nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Scene builders
+static int width, height;
+
+static V4pPolygonP addQuad(V4pProps t, V4pLayer z) {
+    V4pCoord x = rnd(width), y = rnd(height), s = 20 + rnd(100);
+    V4pPolygonP p = v4p_addNew(t, 1 + rnd(200), z);
+    // A slightly skewed quad, so that edges are not all vertical
+    v4p_addPoint(p, x, y);
+    v4p_addPoint(p, x + s, y + rnd(s / 2));
+    v4p_addPoint(p, x + s - rnd(s / 2), y + s);
+    v4p_addPoint(p, x - rnd(s / 2), y + s - rnd(s / 2));
+    return p;
+}
+
+static void buildPolygons(int n) {
+    for (int i = 0; i < n; i++) addQuad(V4P_ABSOLUTE, i);
+}
+
+static void buildDisks(int n) {
+    for (int i = 0; i < n; i++) v4p_addNewDisk(V4P_ABSOLUTE, 1 + rnd(200), i, rnd(width), rnd(height), 5 + rnd(60));
+}
+
+static void buildStroked(int n) {
+    for (int i = 0; i < n; i++) {
+        V4pPolygonP p = (i & 1) ? addQuad(V4P_ABSOLUTE, i)
+                                : v4p_addNewDisk(V4P_ABSOLUTE, 1 + rnd(200), i, rnd(width), rnd(height), 5 + rnd(60));
+        v4p_setStroke(p, 1);
+    }
+}
+
+static void buildSubtree(int n) {
+    const int depth = 8;
+    for (int i = 0; i < n; i += depth) {
+        V4pCoord x = rnd(width), y = rnd(height), s = 40 + rnd(120);
+        V4pPolygonP p = v4p_addNew(V4P_ABSOLUTE, 1 + rnd(200), i);
+        v4p_addCorners(p, x, y, x + s, y + s);
+        for (int d = 1; d < depth && i + d < n; d++) {
+            V4pCoord m = d * s / (2 * depth);
+            p = v4p_addNewSub(p, V4P_ABSOLUTE, 1 + rnd(200), i + d);
+            v4p_addCorners(p, x + m, y + m, x + s - m, y + s - m);
+        }
+    }
+}
+
+static void buildRelative(int n) {
+    for (int i = 0; i < n; i++) addQuad(V4P_RELATIVE, i);
+}
+
+// Same polygons as buildPolygons, under a scrolled view
+static void buildAbsolute(int n) {
+    buildPolygons(n);
+    v4p_setView(width / 3, height / 4, width + width / 3, height + height / 4);
+}
+
+static void buildZoomed(int n) {
+    buildPolygons(n);
+    v4p_setView(width / 4, height / 4, width * 3 / 4, height * 3 / 4);
+}
+
+// A world of 16x16 displays, the view showing one of them
+static void buildWorld(int n) {
+    for (int i = 0; i < n; i++) {
+        V4pPolygonP p = addQuad(V4P_ABSOLUTE, i);
+        v4p_transform(p, width * (rnd(16) - 8), height * (rnd(16) - 8), 0, 0, 256, 256);
+    }
+}
+
+typedef struct {
+    const char* name;
+    void (*build)(int n);
+} Scene;
+
+static const Scene scenes[] = {
+    { "polygons", buildPolygons },
+    { "disks", buildDisks },
+    { "stroked", buildStroked },
+    { "subtree", buildSubtree },
+    { "relative", buildRelative },
+    { "absolute", buildAbsolute },
+    { "zoomed", buildZoomed },
+    { "world", buildWorld },
+};
+#define SCENES_NB ((int) (sizeof(scenes) / sizeof(scenes[0])))
+
+// Sum of scanlines crossed by all active edges of a polygon chain
+static long countEdgeRows(V4pPolygonP p) {
+    long rows = 0;
+    for (; p; p = p->next) {
+        for (List l = p->ActiveEdge1; l; l = ListNext(l)) {
+            ActiveEdgeP ae = (ActiveEdgeP) ListData(l);
+            V4pCoord y0 = IMAX(ae->avy, 0), y1 = IMIN(ae->bvy, height);
+            if (y1 > y0) rows += y1 - y0;
+        }
+        rows += countEdgeRows(p->sub1);
+    }
+    return rows;
+}
+
+// Move every polygon back and forth
+static void animate(V4pPolygonP p, int frame) {
+    V4pCoord d = (frame & 1) ? 1 : -1;
+    for (; p; p = p->next) v4p_transform(p, d, d, 0, 0, 256, 256);
+}
+
+static uint32_t checksum() {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (long i = 0; i < (long) width * height; i++) h = (h ^ shadow[i]) * 16777619u;
+    return h;
+}
+
+// Per frame breakdown of render statistics (when collected)
+static void printStats(const V4pRenderStats* st) {
+    if (! st->frames) return;
+    double f = st->frames;
+    if (st->totalTime) {
+        printf("  ns/frame:  build %.0f  open %.0f  shift %.0f  sort %.0f  depth %.0f  slice %.0f\n",
+               st->buildTime / f, st->openTime / f, st->shiftTime / f, st->sortTime / f, st->depthTime / f,
+               st->sliceTime / f);
+    }
+    printf("  per frame: built %.1f  opened %.1f  closed %.1f  sorts %.1f  inserts %.1f  deletes %.1f"
+           "  slices %.1f  skipped rows %.1f  collisions %.1f\n",
+           st->edgesBuilt / f, st->edgesOpened / f, st->edgesClosed / f, st->sorts / f, st->depthInserts / f,
+           st->depthDeletes / f, st->slices / f, st->rowsSkipped / f, st->collisions / f);
+}
+
+static void runScene(const Scene* s, int n, int frames, int threads, int cell, bool animated, bool cached) {
+    V4pSceneP scene = v4p_newScene(s->name);
+    V4pContextP c = v4p_newContext(scene);
+    v4p_setContext(c);
+    v4p_setRenderThreads(threads);
+    v4p_setView(0, 0, width, height);
+    v4p_setBGColor(V4P_BLACK);
+    seed = 1;
+    s->build(n);
+    if (cell) v4p_setSceneGrid(scene, cell);
+
+    shadow = calloc(width * height, 1);
+    v4p_render();  // warm-up: builds active edges
+    v4p_resetRenderStats();
+    slices = 0;
+    int64_t t0 = nanos();
+    for (int f = 0; f < frames; f++) {
+        if (animated) animate(scene->polygons, f);
+        if (! cached) v4p_invalidate();  // draw all rows, not only changed ones
+        v4p_render();
+    }
+    int64_t t = nanos() - t0;
+    double edgesPerRow = (double) countEdgeRows(scene->polygons) / height;
+
+    printf("%-10s %6d %6d %12.0f %12.1f %10.1f %12.1f   %08x\n", s->name, n, frames, (double) t / frames,
+           (double) t / frames / height, edgesPerRow, (double) slices / frames, checksum());
+    printStats(v4p_getRenderStats());
+
+    free(shadow);
+    shadow = NULL;
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(scene);
+}
+
+int main(int argc, char** argv) {
+    int n = 200, frames = 200, threads = 1, cell = 0;
+    bool animated = false, cached = false;
+    const char* selected[SCENES_NB];
+    int selectedNb = 0;
+    width = 640;
+    height = 480;
+
+    for (int i = 1; i < argc; i++) {
+        if (! strcmp(argv[i], "-n") && i + 1 < argc) {
+            n = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "-f") && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "-s") && i + 1 < argc) {
+            sscanf(argv[++i], "%dx%d", &width, &height);
+        } else if (! strcmp(argv[i], "-t") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "-g") && i + 1 < argc) {
+            cell = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "-a")) {
+            animated = true;
+        } else if (! strcmp(argv[i], "-c")) {
+            cached = true;
+        } else if (argv[i][0] != '-' && selectedNb < SCENES_NB) {
+            selected[selectedNb++] = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-n count] [-f frames] [-s WxH] [-t threads] [-g cell] [-a] [-c] [scene...]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (n <= 0 || frames <= 0 || threads <= 0 || cell < 0 || width <= 0 || height <= 0) return 1;
+
+    if (v4p_init()) return 1;
+    V4piContextP display = v4pi_newContext(width, height);
+    if (! display) return 1;
+    v4pi_setContext(display);
+
+    printf("%-10s %6s %6s %12s %12s %10s %12s   %s\n", "scene", "count", "frames", "ns/frame", "ns/scanline",
+           "edges/row", "slices/frame", "checksum");
+    for (int i = 0; i < SCENES_NB; i++) {
+        bool run = ! selectedNb;
+        for (int j = 0; j < selectedNb; j++) run |= ! strcmp(selected[j], scenes[i].name);
+        if (run) runScene(&scenes[i], n, frames, threads, cell, animated, cached);
+    }
+
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(display);
+    v4p_quit();
+    return 0;
+}
@@ -286,7 +286,7 @@ void createAsteroid() {
     if (asteroid_count >= MAX_ASTEROIDS) return;
     
     V4pPolygonP asteroid_proto = getAsteroidPrototypeSingleton();
-    asteroids[asteroid_count] = v4p_addClone(asteroid_proto);
+    asteroids[asteroid_count] = v4p_addNewInstance(asteroid_proto);
     v4p_setColor(asteroids[asteroid_count], 139 + v4p_getId(asteroids[asteroid_count]) % 14);
 
     // Position asteroid randomly around the edges
@@ -378,7 +378,7 @@ void resetGameState() {
 void fireBullet() {
     
     V4pPolygonP bullet_proto = createBulletPrototype();
-    bullets[bullet_count] = v4p_addClone(bullet_proto);
+    bullets[bullet_count] = v4p_addNewInstance(bullet_proto);
     
     // Position bullet at ship's nose using v4p's trigonometric system
     int sina, cosa;
@@ -594,7 +594,7 @@ int g4p_onTick(int32_t deltaTime) {
                     for (int k = 0; k < 2; k++) {
                         if (asteroid_count < MAX_ASTEROIDS) {
                             V4pPolygonP asteroid_proto = getAsteroidPrototypeSingleton();
-                            asteroids[asteroid_count] = v4p_addClone(asteroid_proto);
+                            asteroids[asteroid_count] = v4p_addNewInstance(asteroid_proto);
                             v4p_setLayer(asteroids[asteroid_count], layer); // Keep same layer for split asteroids
                             v4p_setColor(asteroids[asteroid_count], v4p_getColor(asteroids[j]));
                             
@@ -56,16 +56,6 @@ typedef enum { idle, push, edit } GuiStatus;
 int spotNb;
 GuiStatus guiStatus;
 
-// Collision point callback
-V4pPolygonP polygonUnderPen=NULL;
-void g4p_onCollisionPoint(V4pPolygonP p1,
-                          V4pPolygonP p2,
-                          V4pCoord avg_x,
-                          V4pCoord avg_y,
-                          uint16_t count) {
-    polygonUnderPen = p2;    
-}
-
 int g4p_onInit(int quality, bool fullscreen) {
     v4p_init2(quality, fullscreen);
     v4p_setBGColor(V4P_GREEN);
@@ -111,9 +101,6 @@ int g4p_onInit(int quality, bool fullscreen) {
     v4p_addCorners(pSelGrid, -xvu - 2, -yvu - 2, -xvu + 2, -yvu + 2);
     v4p_disable(pGrid);
 
-    // Set collision point callback
-    g4p_setCollisionCallback(g4p_onCollisionPoint);
-
     return success;
 }
 
@@ -170,6 +157,8 @@ int g4p_onTick(int32_t deltaTime) {
                         v4p_transform(pSelLayer, 0, (precZ - currentZ) * 2, 0, 0, 256, 256);
                 }
             } else if (guiStatus == edit) {  // screen move
+                // edited polygon under the pen, as drawn at last frame
+                V4pPolygonP polygonUnderPen = v4p_pickMasked(g4p_state.xpen, g4p_state.ypen, 1);
                 if (brush) {
                     if (sel == bScroll) {
                         v4p_destroyFromScene(brush);
@@ -212,14 +201,14 @@ int g4p_onTick(int32_t deltaTime) {
                             s = v4p_getPoints(focus);
                             mindist = gaugeDist(s->x - x, s->y - y);
                             currentPoint = s;
-                            s = s->next;
+                            s = v4p_nextPoint(s);
                             while (s) {
                                 dist = gaugeDist(s->x - x, s->y - y);
                                 if (dist < mindist) {
                                     mindist = dist;
                                     currentPoint = s;
                                 }
-                                s = s->next;
+                                s = v4p_nextPoint(s);
                             }
                         }
                     } else
@@ -287,7 +276,6 @@ int g4p_onTick(int32_t deltaTime) {
                              g4p_state.ypen - 1,
                              g4p_state.xpen + 1,
                              g4p_state.ypen + 1);
-                    v4p_setCollisionMask(brush, 2);
                     xpen0 = g4p_state.xpen;
                     ypen0 = g4p_state.ypen;
                     guiStatus = edit;
@@ -332,7 +320,6 @@ int g4p_onTick(int32_t deltaTime) {
 }
 
 int g4p_onFrame() {
-    polygonUnderPen = NULL;
     v4p_render();
     return success;
 }
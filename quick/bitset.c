@@ -0,0 +1,97 @@
+/**
+ * Hierarchical bitsets
+ *
+ * Level 0 holds a bit per element. Each upper level holds a bit per word of the level below,
+ * set when that word is not empty. The top level is a single word.
+ * - Toggle flips a bit then climbs up only while a word turns empty or not empty.
+ * - Max walks down from the top word, picking the highest set bit at each level.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bitset.h"
+#include "imath.h"
+
+QuickBitset QuickBitsetNew(int capacity) {
+    QuickBitset b = (QuickBitset) malloc(sizeof(QuickBitsetS));
+    if (! b) {
+        return NULL;
+    }
+    b->words = NULL;
+    b->capacity = -1;
+    if (QuickBitsetReserve(b, capacity)) {
+        free(b);
+        return NULL;
+    }
+    return b;
+}
+
+void QuickBitsetDestroy(QuickBitset b) {
+    free(b->words);
+    free(b);
+}
+
+int QuickBitsetReserve(QuickBitset b, int capacity) {
+    if (capacity < 1) capacity = 1;
+    if (capacity <= b->capacity) {
+        QuickBitsetReset(b);
+        return success;
+    }
+
+    // count words of each level
+    int sizes[QUICK_BITSET_LEVELS];
+    int levels = 0, size = 0, n = capacity;
+    do {
+        n = (n + 31) >> 5;
+        sizes[levels++] = n;
+        size += n;
+    } while (n > 1 && levels < QUICK_BITSET_LEVELS);
+    if (n > 1) {
+        return failure;  // too big
+    }
+
+    uint32_t* words = (uint32_t*) malloc(sizeof(uint32_t) * size);
+    if (! words) {
+        return failure;
+    }
+    free(b->words);
+    b->words = words;
+    b->levels = levels;
+    b->capacity = capacity;
+    b->size = size;
+    for (int k = 0, offset = 0; k < levels; offset += sizes[k], k++) {
+        b->level[k] = words + offset;
+    }
+    QuickBitsetReset(b);
+    return success;
+}
+
+void QuickBitsetReset(QuickBitset b) {
+    memset(b->words, 0, sizeof(uint32_t) * b->size);
+}
+
+bool QuickBitsetToggle(QuickBitset b, int i) {
+    uint32_t bit = (uint32_t) 1 << (i & 31);
+    uint32_t* w = &b->level[0][i >> 5];
+    bool set = ! (*w & bit);
+    *w ^= bit;
+    // climb up while the word emptiness changes
+    for (int k = 1; k < b->levels && *w == (set ? bit : 0); k++) {
+        i >>= 5;
+        bit = (uint32_t) 1 << (i & 31);
+        w = &b->level[k][i >> 5];
+        *w ^= bit;
+    }
+    return set;
+}
+
+int QuickBitsetMax(QuickBitset b) {
+    int i = 0;
+    for (int k = b->levels - 1; k >= 0; k--) {
+        uint32_t w = b->level[k][i];
+        if (! w) {
+            return -1;  // only possible at top level
+        }
+        i = (i << 5) | floorLog2(w);
+    }
+    return i;
+}
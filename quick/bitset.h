@@ -0,0 +1,41 @@
+#ifndef QUICKBITSET_H
+#define QUICKBITSET_H
+/**
+ * Hierarchical bitsets
+ * A bit per element plus summary levels (bit i of level k+1 set when word i of level k is not empty),
+ * so that toggling a bit and finding the highest set bit cost O(log32(n)), without any allocation.
+ */
+#include "v4p_ll.h"
+
+#define QUICK_BITSET_LEVELS 6  // up to 2^30 elements
+
+typedef struct sQuickBitset {
+    uint32_t* words;  // all levels words, level 0 first
+    uint32_t* level[QUICK_BITSET_LEVELS];  // level[0]: element bits, level[levels - 1]: a single word
+    int levels;
+    int capacity;  // number of elements
+    int size;  // number of words
+} QuickBitsetS, *QuickBitset;
+
+// Create a bitset able to hold 'capacity' bits
+QuickBitset QuickBitsetNew(int capacity);
+
+// Free a bitset
+void QuickBitsetDestroy(QuickBitset b);
+
+// Ensure the bitset holds at least 'capacity' bits (grows only). The bitset is cleared.
+int QuickBitsetReserve(QuickBitset b, int capacity);
+
+// Clear all bits
+void QuickBitsetReset(QuickBitset b);
+
+// Flip bit i and return its new value
+bool QuickBitsetToggle(QuickBitset b, int i);
+
+// Highest set bit, -1 if none
+int QuickBitsetMax(QuickBitset b);
+
+#define QuickBitsetIsEmpty(b) (! (b)->level[(b)->levels - 1][0])
+#define QuickBitsetGet(b, i) (((b)->level[0][(i) >> 5] >> ((i) & 31)) & 1)
+
+#endif
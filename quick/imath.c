@@ -49,13 +49,25 @@ int floorLog232(uint32_t v) {
  *  in the range [0, 512) where 512 represents a full circle (360 degrees).
  */
 int computeCosSin(uint16_t angle) {
+    QuickRotation r;
+    angle = (angle & (uint16_t) 0x1FF);
+    if (angle == lastAngle) return success;
+
+    computeRotation(&r, angle);
+    lastAngle = r.angle;
+    lwmCosa = r.cosa;
+    lwmSina = r.sina;
+    return success;
+}
+
+/** Compute cosine and sine values of a rotation, without global state
+ */
+void computeRotation(QuickRotation* r, uint16_t angle) {
     // Use a lookup table for cosine values and derives sine from it
     int tb, tr;
     uint16_t b;
     angle = (angle & (uint16_t) 0x1FF);
-    if (angle == lastAngle) return success;
-
-    lastAngle = angle;
+    r->angle = angle;
     b = angle & (uint16_t) 127; // b is 0 to 127
 
     if (! (angle & (uint16_t) 256)) {  // First 1/2 circle
@@ -67,22 +79,26 @@ int computeCosSin(uint16_t angle) {
     }
 
     if (! (angle & (uint16_t) 128)) {  // 1st or 3d 1/4 circle
-        lwmCosa = tb;
-        lwmSina = tr;
+        r->cosa = tb;
+        r->sina = tr;
     } else {
-        lwmCosa = -tr;
-        lwmSina = tb;
+        r->cosa = -tr;
+        r->sina = tb;
     }
-    return success;
 }
 
 void straighten(V4pCoord x, V4pCoord y, V4pCoord* xn, V4pCoord* yn) {
-    if (! lastAngle) {
+    QuickRotation r = { lastAngle, lwmCosa, lwmSina };
+    straightenWith(&r, x, y, xn, yn);
+}
+
+void straightenWith(const QuickRotation* r, V4pCoord x, V4pCoord y, V4pCoord* xn, V4pCoord* yn) {
+    if (! r->angle) {
         *xn = x;
         *yn = y;
     } else {
-        *xn = (x * lwmCosa - y * lwmSina) >> 8;
-        *yn = (x * lwmSina + y * lwmCosa) >> 8;
+        *xn = (x * r->cosa - y * r->sina) >> 8;
+        *yn = (x * r->sina + y * r->cosa) >> 8;
     }
 }
 
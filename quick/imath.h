@@ -7,6 +7,12 @@ extern uint16_t lwmAngle;
 extern int lwmCosa;
 extern int lwmSina;
 
+// A rotation, for re-entrant code (cos/sin in 1 / 255 unit)
+typedef struct {
+    uint16_t angle;
+    int cosa, sina;
+} QuickRotation;
+
 // compute floor(log2(int))
 // floorLog2(10) = floor(log2(10)) = 3
 int floorLog2(uint32_t v);
@@ -17,6 +23,9 @@ int floorLog232(uint32_t v);
 // compute cos/sin and upate lwmCosa, lwmSina (1 / 255 unit)
 int computeCosSin(uint16_t angle);
 
+// compute cos/sin of a rotation (re-entrant computeCosSin)
+void computeRotation(QuickRotation* r, uint16_t angle);
+
 // Sign function for proper rounding: returns -1, 0, or 1
 #define SIGN(x) (((x) > 0) - ((x) < 0))
 
@@ -35,6 +44,9 @@ int computeCosSin(uint16_t angle);
 // rotate (x,y) vector according to current transformation (computeCosSin must have been called before)
 void straighten(V4pCoord x, V4pCoord y, V4pCoord* xn, V4pCoord* yn);
 
+// rotate (x,y) vector according to a rotation (re-entrant straighten)
+void straightenWith(const QuickRotation* r, V4pCoord x, V4pCoord y, V4pCoord* xn, V4pCoord* yn);
+
 // Jim Henry's isqrt
 uint16_t isqrt(uint16_t v);
 uint16_t isqrt32(uint32_t v);
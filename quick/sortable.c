@@ -11,38 +11,28 @@
 #include "sortable.h"
 #include "heap.h"
 
-// A Heap for lists
-static QuickHeapS listHeapS = QuickHeapInitializerFor(struct sList);
-static QuickHeap listHeap = &listHeapS;
-
-// A settable function to compare lists. Please set it before sorting!
-// Must return (arg1 < arg2)
-int (*ListCompareFunc)(void*, void*) = NULL;
-
-// create a list item
-List ListNew() {
-    // QuickHeapReserve(listHeap, 2048); // This will work only once. That's
-    // fine.
-    return (List) QuickHeapAlloc(listHeap);
+// create a list item in a given heap
+List ListNewIn(QuickHeap heap) {
+    return (List) QuickHeapAlloc(heap);
 }
 
-// free a list item and return next
-List ListFree(List p) {
+// free a list item from a given heap and return next
+List ListFreeIn(QuickHeap heap, List p) {
     List next = p->next;
-    QuickHeapFree(listHeap, (void*) p);
+    QuickHeapFree(heap, (void*) p);
     return next;
 }
 
 // merge 2 lists
 // sort direction is kept by altering links in place
-List ListMerge(List previous, List after) {
+List ListMerge(List previous, List after, ListComparator compare) {
     List head, last, tmp;
 
     if (! previous && ! after)
         return NULL;
 
     if (! previous
-        || (after && ListCompare(after, previous))) {  // 1st swapping of after & previous lists
+        || (after && ListCompare(compare, after, previous))) {  // 1st swapping of after & previous lists
         tmp = previous;
         previous = after;
         after = tmp;
@@ -51,7 +41,7 @@ List ListMerge(List previous, List after) {
     previous = ListNext(last);
 
     while (previous && after) {
-        if (ListCompare(after, previous)) {
+        if (ListCompare(compare, after, previous)) {
             // swap after & previous lists // xor swap?
             tmp = previous;
             previous = after;
@@ -70,14 +60,14 @@ List ListMerge(List previous, List after) {
 }
 
 // cut list at end of the first rise, and returns the next rise
-List ListExtractRise(List list) {
+List ListExtractRise(List list, ListComparator compare) {
     List last, l;
 
     if (! list)
         return NULL;
 
     // sorting break search loop
-    for (last = l = list, l = ListNext(l); l && ! ListCompare(l, last); last = l, l = ListNext(l))
+    for (last = l = list, l = ListNext(l); l && ! ListCompare(compare, l, last); last = l, l = ListNext(l))
         ;
 
     // cut l at ordering break
@@ -93,7 +83,7 @@ List ListExtractRise(List list) {
 // in 'level' : binary tree size
 // returns: the ordered sub-list
 // out 'remaining' : the remaining unordered part of the list
-static List down(List list, int level, List* remaining) {
+static List down(List list, int level, List* remaining, ListComparator compare) {
     List sub_remaining, l1, l2;
     if (! list) {
         *remaining = NULL;
@@ -101,29 +91,29 @@ static List down(List list, int level, List* remaining) {
     }
 
     if (! level) {
-        *remaining = ListExtractRise(list);
+        *remaining = ListExtractRise(list, compare);
         return list;
     }
 
-    l1 = down(list, level - 1, &sub_remaining);
-    l2 = down(sub_remaining, level - 1, remaining);
-    return ListMerge(l1, l2);
+    l1 = down(list, level - 1, &sub_remaining, compare);
+    l2 = down(sub_remaining, level - 1, remaining, compare);
+    return ListMerge(l1, l2, compare);
 }
 
 // repeat until exhaustion of the unordered part of the list :
 //  merge-sort a part of list of same weight than the already ordered list
 //  then merge both as a weight+1 ordered list
 
-List ListSort(List list) {
+List ListSort(List list, ListComparator compare) {
     List done = NULL, remaining, ordered;
     int level = 0;
     if (! list)
         return NULL;
     done = list;
-    list = ListExtractRise(list);
+    list = ListExtractRise(list, compare);
     while (list) {
-        ordered = down(list, level, &remaining);
-        done = ListMerge(done, ordered);
+        ordered = down(list, level, &remaining, compare);
+        done = ListMerge(done, ordered, compare);
         level++;
         list = remaining;
     }
@@ -5,10 +5,11 @@
  * Experimental inline version of a Divide & Conquer type sort algorithm
  */
 
-// A settable function to compare lists. Please set it before sorting!
+#include "quick/heap.h"
+
+// A function to compare list data, passed to the sorting functions
 // must return (arg1 < arg2)
-extern int (*ListCompareFunc)(void*, void*);
-#define ListSetCompareFunc(p) ListCompareFunc = (p)
+typedef int (*ListComparator)(void*, void*);
 
 // A classical linked list of orderable data
 typedef struct sList {
@@ -17,34 +18,32 @@ typedef struct sList {
     struct sList* quick /* reserved for quicktable */;
 }* List;
 
-// create list
-List ListNew();
-
-// free list and return next
-List ListFree(List p);
+// create/free list items in a given heap (e.g. private to a thread)
+List ListNewIn(QuickHeap heap);
+List ListFreeIn(QuickHeap heap, List p);
 
 #define ListData(l) ((l)->data)
 #define ListNext(l) ((l)->next)
 #define ListSetData(l, d) ((l)->data = (d))
 #define ListSetNext(l, n) ((l)->next = (n))
-#define ListCompare(A, B) ListCompareFunc((A)->data, (B)->data)
+#define ListCompare(compare, A, B) (compare)((A)->data, (B)->data)
 #define ListPrependElement(l, n) (ListSetNext((n), (l)), (l) = (n))
-#define ListPrepend(l, d) \
+#define ListPrependIn(heap, l, d) \
     { \
-        List _nXYZ = ListNew(); \
+        List _nXYZ = ListNewIn(heap); \
         ListSetData(_nXYZ, (d)); \
         ListPrependElement((l), _nXYZ); \
     }
 
 // merge 2 lists
-List ListMerge(List previous, List after);
+List ListMerge(List previous, List after, ListComparator compare);
 
 // cut list at end of the first rise, and returns the next rise
-List ListExtractRise(List l);
+List ListExtractRise(List l, ListComparator compare);
 
 // repeat until exhaustion of the unordered list :
 //  - merge-sort a sub-list which weights as much as the already ordered list
 //  - then merge both as a weight+1 ordered list
-List ListSort(List list);
+List ListSort(List list, ListComparator compare);
 
 #endif
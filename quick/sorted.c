@@ -17,13 +17,22 @@ typedef struct sTreeNode {
 
 // A settable function to compare tree data. Please set it before using!
 // Must return <0 if a<b, 0 if a==b, >0 if a>b
-int (*TreeCompareFunc)(void*, void*) = NULL;
+TreeComparator TreeCompareFunc = NULL;
+
+// Compare with the tree comparator
+#define TreeCompare(T, A, B) ((T)->compare ? (T)->compare((A), (B)) : TreeCompareFunc((A), (B)))
 
 // Create a new tree
 QuickTree* TreeNew() {
+    return TreeNewWith(NULL);
+}
+
+// Create a new tree with its own comparator
+QuickTree* TreeNewWith(TreeComparator compare) {
     QuickTree* tree = (QuickTree*) malloc(sizeof(QuickTree));
     tree->root = NULL;
     tree->nodeHeap = QuickHeapNewFor(TreeNode);
+    tree->compare = compare;
     return tree;
 }
 
@@ -89,7 +98,7 @@ TreeNodeP TreeInsertNode(QuickTree* tree, TreeNodeP node, void* data) {
         return newNode;
     }
 
-    int cmp = TreeCompareFunc(data, node->data);
+    int cmp = TreeCompare(tree, data, node->data);
     if (cmp < 0) {
         node->left = TreeInsertNode(tree, node->left, data);
     } else if (cmp > 0) {
@@ -107,23 +116,23 @@ TreeNodeP TreeInsertNode(QuickTree* tree, TreeNodeP node, void* data) {
     int balance = TreeBalance(node);
 
     // Left Left Case (data < node->left->data)
-    if (balance > 1 && node->left && TreeCompareFunc(data, node->left->data) < 0) {
+    if (balance > 1 && node->left && TreeCompare(tree, data, node->left->data) < 0) {
         return TreeRotateRight(node);
     }
 
     // Right Right Case (data > node->right->data)
-    if (balance < -1 && node->right && TreeCompareFunc(node->right->data, data) < 0) {
+    if (balance < -1 && node->right && TreeCompare(tree, node->right->data, data) < 0) {
         return TreeRotateLeft(node);
     }
 
     // Left Right Case (data > node->left->data)
-    if (balance > 1 && node->left && TreeCompareFunc(node->left->data, data) < 0) {
+    if (balance > 1 && node->left && TreeCompare(tree, node->left->data, data) < 0) {
         node->left = TreeRotateLeft(node->left);
         return TreeRotateRight(node);
     }
 
     // Right Left Case (data < node->right->data)
-    if (balance < -1 && node->right && TreeCompareFunc(data, node->right->data) < 0) {
+    if (balance < -1 && node->right && TreeCompare(tree, data, node->right->data) < 0) {
         node->right = TreeRotateRight(node->right);
         return TreeRotateLeft(node);
     }
@@ -150,7 +159,7 @@ TreeNodeP TreeFindMinNode(TreeNodeP node) {
 TreeNodeP TreeDeleteNode(QuickTree* tree, TreeNodeP node, void* data) {
     if (!node) return NULL;
 
-    int cmp = TreeCompareFunc(data, node->data);
+    int cmp = TreeCompare(tree, data, node->data);
     if (cmp < 0) {
         node->left = TreeDeleteNode(tree, node->left, data);
     } else if (cmp > 0) {
@@ -236,7 +245,7 @@ void* TreeFindMin(QuickTree* tree) {
 bool TreeContains(QuickTree* tree, void* data) {
     TreeNodeP node = tree->root;
     while (node) {
-        int cmp = TreeCompareFunc(data, node->data);
+        int cmp = TreeCompare(tree, data, node->data);
         if (cmp == 0) {
             return true;
         } else if (cmp < 0) {
@@ -9,7 +9,8 @@
 
 // A settable function to compare tree data. Please set it before using!
 // Must return <0 if a<b, 0 if a==b, >0 if a>b
-extern int (*TreeCompareFunc)(void*, void*);
+typedef int (*TreeComparator)(void*, void*);
+extern TreeComparator TreeCompareFunc;
 
 typedef struct sTreeNode* TreeNodeP;
 
@@ -17,11 +18,15 @@ typedef struct sTreeNode* TreeNodeP;
 typedef struct sTree {
     TreeNodeP root;
     QuickHeap nodeHeap;
+    TreeComparator compare;  // Tree own comparator, or NULL to use TreeCompareFunc
 } QuickTree;
 
 // Create a new tree
 QuickTree* TreeNew();
 
+// Create a new tree with its own comparator (re-entrant)
+QuickTree* TreeNewWith(TreeComparator compare);
+
 // Free a tree
 void TreeDestroy(QuickTree* tree);
 
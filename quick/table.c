@@ -7,7 +7,7 @@
  *
  * Memory Model:
  * - Does NOT own the List data - only manages table structure
- * - List elements must be allocated elsewhere (typically via ListNew())
+ * - List elements must be allocated elsewhere (typically via ListNewIn())
  * - QuickTableResetAndFree() frees List nodes but NOT their data pointers
  *   so be sure to free data separately if needed
  *
@@ -42,14 +42,14 @@ void QuickTableReset(QuickTable q) {
     memset(q->table, 0, sizeof(List) * q->sizeOfTable);
 }
 
-// Free all List elements in the table (but not their data) and clear the table
-void QuickTableResetAndFree(QuickTable q) {
+// Free all List elements in the table back to their heap (but not their data) and clear the table
+void QuickTableResetAndFree(QuickTable q, QuickHeap heap) {
     for (size_t i = 0; i < q->sizeOfTable; i++) {
         List current = q->table[i];
         while (current != NULL) {
             List next = current->quick;  // Get next before freeing current
             // Free the list element itself
-            ListFree(current);
+            ListFreeIn(heap, current);
             
             current = next;
         }
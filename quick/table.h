@@ -14,7 +14,7 @@ typedef struct sQuickTable {
 QuickTable QuickTableNew(size_t sizeOfTable);
 void QuickTableDestroy(QuickTable t);
 void QuickTableReset(QuickTable q);
-void QuickTableResetAndFree(QuickTable q);
+void QuickTableResetAndFree(QuickTable q, QuickHeap heap);
 
 List QuickTableAdd(QuickTable q, int index, List l);
 void QuickTableRemove(QuickTable q, int index, List l);
@@ -0,0 +1,18 @@
+/**
+ * Checks shared by tests
+ * check() reports a condition and counts failed ones into errors, returned by the test main().
+ */
+#ifndef V4P_TESTS_CHECK_H
+#define V4P_TESTS_CHECK_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+static int errors = 0;
+
+static inline void check(bool cond, const char* what) {
+    printf("%s %s\n", cond ? "✓" : "✗", what);
+    if (! cond) errors++;
+}
+
+#endif
@@ -8,6 +8,8 @@ static int collision_callback_count = 0;
 static int collision_point_callback_count = 0;
 
 // Forward declarations
+void custom_collision_callback(V4pCollisionLayer i1, V4pCollisionLayer i2, V4pCoord py,
+                               V4pCoord x1, V4pCoord x2, V4pPolygonP p1, V4pPolygonP p2);
 void test_collision_point_callback(V4pPolygonP p1, V4pPolygonP p2, V4pCoord avg_x, V4pCoord avg_y, uint16_t count);
 
 // Game state
@@ -18,7 +20,11 @@ V4pPolygonP poly3 = NULL;
 // Game initialization
 int g4p_onInit(int quality, bool fullscreen) {
     printf("=== COLLISION POINTS TEST ===\n");
-    
+    v4p_init2(quality, fullscreen);
+
+    // Set our custom collision callback
+    v4p_setCollisionCallback(custom_collision_callback);
+
     // Set collision point callback
     g4p_setCollisionCallback(test_collision_point_callback);
     
@@ -119,9 +125,6 @@ void test_collision_point_callback(V4pPolygonP p1, V4pPolygonP p2, V4pCoord avg_
 }
 
 int main(int argc, char* argv[]) {
-    // Set our custom collision callback
-    v4p_setCollisionCallback(custom_collision_callback);
-    
     // Run the game engine
     return g4p_main(argc, argv);
 }
\ No newline at end of file
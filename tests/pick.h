@@ -0,0 +1,48 @@
+/**
+ * Picking checks shared by tests
+ * The polygon picked at each display point must be the one whose color was drawn there.
+ */
+#ifndef V4P_TESTS_PICK_H
+#define V4P_TESTS_PICK_H
+
+#include "check.h"
+
+// Render then pick every point of a w x h display drawn into pixels over a black background,
+// counting points not showing the picked color
+static inline int renderAndPickAll(const uint8_t* pixels, int w, int h) {
+    int mismatches = 0;
+    v4p_render();
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            V4pPolygonP p = v4p_pick(x, y);
+            if ((p ? v4p_getColor(p) : V4P_BLACK) != pixels[y * w + x]) mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Same, checking the picked polygons match the drawn pixels
+static inline void checkPicks(const char* what, const uint8_t* pixels, int w, int h) {
+    char label[112];
+    int mismatches = renderAndPickAll(pixels, w, h);
+    snprintf(label, sizeof(label), "%s: picked polygons match drawn pixels (%d mismatches)", what, mismatches);
+    check(mismatches == 0, label);
+}
+
+// Same in views zoomed out then in around (cx, cy), each zoom being scrolled by -step, 0 and step
+static inline void checkPicksInViews(const uint8_t* pixels, int w, int h, V4pCoord cx, V4pCoord cy, V4pCoord step) {
+    char label[112];
+    int views = 0, failed = 0;
+    for (V4pCoord z = 1; z <= 5; z++) {
+        for (V4pCoord dy = -step; dy <= step; dy += step, views++) {
+            V4pCoord vw = z < 3 ? w * (3 - z) : w / (z - 1), vh = z < 3 ? h * (3 - z) : h / (z - 1);
+            v4p_setView(cx + dy - vw / 2, cy + dy * 2 - vh / 2, cx + dy + vw - vw / 2, cy + dy * 2 + vh - vh / 2);
+            if (renderAndPickAll(pixels, w, h)) failed++;
+        }
+    }
+    snprintf(label, sizeof(label), "zoomed and scrolled views: picked polygons match drawn pixels (%d/%d differ)",
+             failed, views);
+    check(failed == 0, label);
+}
+
+#endif
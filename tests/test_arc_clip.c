@@ -36,7 +36,7 @@ int g4p_onTick(int32_t deltaTime) {
         int disk_point_count = 0;
         while (point) {
             disk_point_count++;
-            point = point->next;
+            point = v4p_nextPoint(point);
         }
         printf("Created disk with %d points\n", disk_point_count);
 
@@ -67,7 +67,7 @@ int g4p_onTick(int32_t deltaTime) {
             int orig_count = 0;
             while (orig_point) {
                 orig_count++;
-                orig_point = orig_point->next;
+                orig_point = v4p_nextPoint(orig_point);
             }
 
             // Count points in clipped result
@@ -76,7 +76,7 @@ int g4p_onTick(int32_t deltaTime) {
             int clip_count = 0;
             while (clip_point) {
                 clip_count++;
-                clip_point = clip_point->next;
+                clip_point = v4p_nextPoint(clip_point);
             }
 
             printf("  Original disk: %d points\n", orig_count);
@@ -0,0 +1,160 @@
+/**
+ * Test for Bezier curves
+ * Quadratic and cubic curves are drawn as few edges stepped along the curve, close to the same
+ * curves flattened into many straight edges. Picking opens these edges at the picked row only: the
+ * polygon picked at each display point must be the one whose color was drawn there, whatever the view.
+ */
+#include "v4p.h"
+#include "addons/v4pserial/v4pserial.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "pick.h"
+
+#define W 160
+#define H 120
+#define FLAT_STEPS 64
+
+static uint8_t pixels[W * H], flatPixels[W * H];
+
+// Path points of the test shapes, a control point being flagged (x, y, 1)
+typedef struct {
+    V4pCoord x, y;
+    int control;
+} PathPoint;
+
+static const PathPoint drop[] = { { 40, 10, 0 }, { 75, 60, 1 }, { 5, 60, 1 }, { 40, 10, 0 } };
+static const PathPoint lens[] = { { 90, 40, 0 }, { 115, 5, 1 }, { 140, 40, 0 }, { 115, 75, 1 }, { 90, 40, 0 } };
+static const PathPoint wave[] = { { 10, 110, 0 }, { 30, 40, 1 }, { 60, 150, 1 }, { 80, 80, 0 },
+                                  { 150, 70, 0 }, { 150, 115, 0 }, { 10, 110, 0 } };
+static const PathPoint egg[] = { { 90, 40, 0 },   { 98, 28, 1 },  { 107, 22, 1 }, { 115, 22, 0 }, { 123, 22, 1 },
+                                 { 132, 28, 1 },  { 140, 40, 0 }, { 148, 52, 1 }, { 123, 57, 1 }, { 115, 57, 0 },
+                                 { 107, 57, 1 },  { 99, 51, 1 },  { 90, 40, 0 } };
+// Arch whose control points are 2.2·10⁹ rows away from its ends, back along its base: x = 1.2·10⁹·t - 6·10⁸ and
+// y = 6.6·10⁹·t·(1 - t) - 1.1·10⁹
+static const PathPoint arch[] = { { -600000000, -1100000000, 0 }, { -200000000, 1100000000, 1 },
+                                  { 200000000, 1100000000, 1 }, { 600000000, -1100000000, 0 },
+                                  { -600000000, -1100000000, 0 } };
+
+// Add a path to a polygon, either with its control points, or flattened into straight edges
+static V4pPolygonP addPath(V4pPolygonP p, const PathPoint* path, int n, bool flat) {
+    for (int i = 0; i < n; i++) {
+        if (! path[i].control) {
+            v4p_addPoint(p, path[i].x, path[i].y);
+            continue;
+        }
+        int c = path[i + 1].control ? 2 : 1;  // control points of this curve
+        if (! flat) {
+            for (int j = 0; j < c; j++) v4p_addControlPoint(p, path[i + j].x, path[i + j].y);
+        } else {  // Bernstein form, points after the first one
+            const PathPoint *p0 = &path[i - 1], *p1 = &path[i], *p2 = &path[i + 1], *p3 = &path[i + c];
+            for (int k = 1; k < FLAT_STEPS; k++) {
+                double t = (double) k / FLAT_STEPS, u = 1 - t, x, y;
+                if (c == 1) {
+                    x = u * u * p0->x + 2 * u * t * p1->x + t * t * p2->x;
+                    y = u * u * p0->y + 2 * u * t * p1->y + t * t * p2->y;
+                } else {
+                    x = u * u * u * p0->x + 3 * u * u * t * p1->x + 3 * u * t * t * p2->x + t * t * t * p3->x;
+                    y = u * u * u * p0->y + 3 * u * u * t * p1->y + 3 * u * t * t * p2->y + t * t * t * p3->y;
+                }
+                v4p_addPoint(p, (V4pCoord) (x + 0.5), (V4pCoord) (y + 0.5));
+            }
+        }
+        i += c - 1;
+    }
+    return p;
+}
+
+static void addShapes(bool flat) {
+    addPath(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), drop, 4, flat);
+    addPath(v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1), lens, 5, flat);
+    addPath(v4p_addNew(V4P_ABSOLUTE, V4P_GREEN, 2), wave, 7, flat);
+    v4p_setStroke(addPath(v4p_addNew(V4P_ABSOLUTE, V4P_WHITE, 3), lens, 5, flat), 1);
+}
+
+int main() {
+    char label[112];
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("curves");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+
+    // Flattened curves first
+    addShapes(true);
+    v4p_render();
+    memcpy(flatPixels, pixels, sizeof(pixels));
+    v4p_clearScene();
+
+    addShapes(false);
+    checkPicks("first frame", pixels, W, H);
+    int differ = 0, drawn = 0;
+    for (int i = 0; i < W * H; i++) {
+        if (pixels[i] != V4P_BLACK) drawn++;
+        if (pixels[i] != flatPixels[i]) differ++;
+    }
+    snprintf(label, sizeof(label), "curves drawn like flattened curves (%d/%d pixels differ)", differ, drawn);
+    check(drawn > W * H / 4 && differ * 50 < drawn, label);
+    check(v4p_getColor(v4p_pick(40, 12)) == V4P_BLUE && v4p_pick(40, 8) == NULL, "cubic curve tip drawn");
+    check(v4p_getColor(v4p_pick(115, 40)) == V4P_RED && v4p_pick(115, 10) == NULL, "quadratic curves drawn");
+    check(v4p_getColor(v4p_pick(45, 100)) == V4P_GREEN && v4p_pick(20, 70) == NULL, "wavy cubic curve drawn");
+    checkPicksInViews(pixels, W, H, 80, 60, 9);
+
+    // SVG paths keep their curves, smooth ones mirroring the former control point
+    v4p_clearScene();
+    v4p_setView(0, 0, W, H);
+    v4p_decodeSVGPath(v4p_addNew(V4P_ABSOLUTE, V4P_RED, 0), "M 90,40 Q 115,5 140,40 q -25,35 -50,0 Z", 1.f);
+    v4p_setStroke(v4p_decodeSVGPath(v4p_addNew(V4P_ABSOLUTE, V4P_WHITE, 1),
+                                    "M90,40 C98,28 107,22 115,22 S132,28 140,40 s-17,17 -25,17 c-8,0 -16,-6 -25,-17z",
+                                    1.f),
+                  1);
+    v4p_render();
+    memcpy(flatPixels, pixels, sizeof(pixels));
+    v4p_clearScene();
+    addPath(v4p_addNew(V4P_ABSOLUTE, V4P_RED, 0), lens, 5, false);
+    v4p_setStroke(addPath(v4p_addNew(V4P_ABSOLUTE, V4P_WHITE, 1), egg, 13, false), 1);
+    v4p_render();
+    check(! memcmp(pixels, flatPixels, sizeof(pixels)), "SVG curves decoded as curves");
+
+    // Far apart control points: the arch turns down at t = 1/2, its top (0, 5.5·10⁸) ending the rows it fills
+    v4p_clearScene();
+    v4p_setView(-W / 2, 550000000 - H / 2, W / 2, 550000000 + H / 2);
+    v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), -W, 550000000 - H, W, 550000000);
+    v4p_render();
+    memcpy(flatPixels, pixels, sizeof(pixels));
+    v4p_clearScene();
+    addPath(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), arch, 5, false);
+    checkPicks("far apart control points", pixels, W, H);
+    drawn = differ = 0;
+    for (int i = 0; i < W * H; i++) {
+        if (pixels[i] != V4P_BLACK) drawn++;
+        if (pixels[i] != flatPixels[i]) differ++;
+    }
+    snprintf(label, sizeof(label), "far apart control points: arch top drawn (%d/%d pixels differ)", differ, drawn);
+    check(drawn == W * H / 2 && differ == 0, label);
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Bezier test FAILED\n" : "Bezier test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Bezier test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
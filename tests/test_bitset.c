@@ -0,0 +1,43 @@
+#include "quick/bitset.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "check.h"
+
+int main() {
+    QuickBitset b = QuickBitsetNew(40);
+    check(b && b->levels == 2, "40 bits need 2 levels");
+    check(QuickBitsetIsEmpty(b) && QuickBitsetMax(b) == -1, "new bitset is empty");
+
+    check(QuickBitsetToggle(b, 3) && QuickBitsetToggle(b, 35), "toggle sets bits");
+    check(QuickBitsetMax(b) == 35, "max is 35");
+    check(! QuickBitsetToggle(b, 35), "toggle clears bit");
+    check(QuickBitsetMax(b) == 3 && QuickBitsetGet(b, 3), "max falls back to 3");
+    QuickBitsetToggle(b, 3);
+    check(QuickBitsetIsEmpty(b), "empty again");
+
+    // Grow to 4 levels, compare against a plain array
+    check(QuickBitsetReserve(b, 40000) == success && b->levels == 4, "40000 bits need 4 levels");
+    static bool plain[40000];
+    int max = -1;
+    srand(1);
+    for (int n = 0; n < 100000; n++) {
+        int i = (rand() % 2) ? rand() % 40000 : rand() % 64;
+        plain[i] = ! plain[i];
+        if (QuickBitsetToggle(b, i) != plain[i]) break;
+        if (n % 1000 == 0) {
+            for (max = 39999; max >= 0 && ! plain[max]; max--)
+                ;
+            if (QuickBitsetMax(b) != max) break;
+        }
+    }
+    for (max = 39999; max >= 0 && ! plain[max]; max--)
+        ;
+    check(QuickBitsetMax(b) == max, "max matches a plain array after random toggles");
+
+    QuickBitsetReset(b);
+    check(QuickBitsetIsEmpty(b) && QuickBitsetMax(b) == -1, "reset clears all bits");
+    QuickBitsetDestroy(b);
+
+    printf(errors ? "Bitset test FAILED\n" : "Bitset test completed successfully!\n");
+    return errors ? 1 : 0;
+}
@@ -20,7 +20,7 @@ int main() {
     int count = 0;
     while (point) {
         printf("Point %d: (%d, %d)\n", count++, point->x, point->y);
-        point = point->next;
+        point = v4p_nextPoint(point);
     }
     
     // Clip the polygon (adjust bounds to intersect with the polygon)
@@ -34,7 +34,7 @@ int main() {
         printf("Clipped polygon points:\n");
         while (point) {
             printf("Point %d: (%d, %d)\n", count++, point->x, point->y);
-            point = point->next;
+            point = v4p_nextPoint(point);
         }
         if (count == 0) {
             printf("No points in clipped polygon.\n");
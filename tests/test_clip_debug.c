@@ -20,7 +20,7 @@ int main() {
     int count = 0;
     while (point) {
         printf("Point %d: (%d, %d)\n", count++, point->x, point->y);
-        point = point->next;
+        point = v4p_nextPoint(point);
     }
     
     // Test clipping with bounds that should intersect the square
@@ -35,7 +35,7 @@ int main() {
         printf("Clipped polygon points:\n");
         while (clippedPoint) {
             printf("Point %d: (%d, %d)\n", clippedCount++, clippedPoint->x, clippedPoint->y);
-            clippedPoint = clippedPoint->next;
+            clippedPoint = v4p_nextPoint(clippedPoint);
         }
         if (clippedCount == 0) {
             printf("No points in clipped polygon.\n");
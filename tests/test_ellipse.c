@@ -0,0 +1,60 @@
+/**
+ * Test for ellipses and disks
+ * Mirror quarters of an ellipse, and their strokes, share a single evaluation per scanline. Picking
+ * still evaluates each arc edge on its own: the polygon picked at each display point must be the one
+ * whose color was drawn there, whatever the view.
+ */
+#include "v4p.h"
+#include <stdio.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "pick.h"
+
+#define W 120
+#define H 90
+
+static uint8_t pixels[W * H];
+
+int main() {
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("ellipses");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP wide = v4p_addNewEllipse(V4P_ABSOLUTE, V4P_BLUE, 0, 60, 45, 50, 20);
+    V4pPolygonP tall = v4p_addNewEllipse(V4P_ABSOLUTE, V4P_RED, 1, 30, 40, 9, 35);
+    v4p_setStroke(v4p_addNewEllipse(V4P_ABSOLUTE, V4P_WHITE, 2, 85, 50, 25, 30), 1);
+    v4p_setStroke(v4p_addNewDisk(V4P_ABSOLUTE, V4P_YELLOW, 3, 70, 30, 13), 1);
+    for (int i = 0; i < 8; i++) v4p_addNewDisk(V4P_ABSOLUTE, 20 + i, 4, 10 + i * 14, 75 - i * 3, 2 + i);
+    check(v4p_addNewEllipse(V4P_ABSOLUTE, V4P_GREEN, 5, 50, 50, 0, 10) != NULL, "flat ellipse created empty");
+
+    checkPicks("first frame", pixels, W, H);
+    check(v4p_pick(15, 45) == wide && v4p_pick(60, 12) == NULL, "wide ellipse drawn");
+    check(v4p_pick(30, 10) == tall && v4p_pick(40, 40) == wide, "tall ellipse drawn");
+    checkPicksInViews(pixels, W, H, 40, 45, 7);
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Ellipse test FAILED\n" : "Ellipse test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Ellipse test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
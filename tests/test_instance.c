@@ -0,0 +1,156 @@
+/**
+ * Test for polygon instances
+ * An instance holds no point: its prototype points are transformed when its edges are built. It must
+ * be drawn exactly like a clone given the same transform, follow the changes of its prototype, and be
+ * left empty when its prototype is destroyed.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 160
+#define H 120
+#define SPRITES 12
+
+static uint8_t pixels[W * H], clonePixels[W * H];
+
+// A ship with a curved nose, a round cockpit sub and a stroked fin sub
+static V4pPolygonP newProto() {
+    V4pPolygonP p = v4p_new(V4P_ABSOLUTE, V4P_BLUE, 10);
+    v4p_addPoint(p, -10, 8);
+    v4p_addControlPoint(p, -6, -12);
+    v4p_addControlPoint(p, 6, -12);
+    v4p_addPoint(p, 10, 8);
+    v4p_addSub(p, v4p_newEllipse(V4P_ABSOLUTE, V4P_WHITE, 11, 0, -1, 3, 4));
+    V4pPolygonP fin = v4p_addNewSub(p, V4P_ABSOLUTE, V4P_RED, 12);
+    v4p_addPoint(fin, -4, 8);
+    v4p_addPoint(fin, 0, 14);
+    v4p_addPoint(fin, 4, 8);
+    v4p_setStroke(fin, 1);
+    v4p_setAnchor(p, 0, 0);
+    return p;
+}
+
+// Add the sprites, as instances or clones, then move them all
+static void addSprites(V4pPolygonP proto, bool instances, V4pPolygonP* sprites) {
+    for (int i = 0; i < SPRITES; i++) sprites[i] = instances ? v4p_addNewInstance(proto) : v4p_addClone(proto);
+}
+
+static void moveSprites(V4pPolygonP* sprites, int frame) {
+    for (int i = 0; i < SPRITES; i++)
+        v4p_transform(sprites[i], 15 + (i % 4) * 40, 20 + (i / 4) * 38, (i * 45 + frame * 13) % 512, i % 3,
+                      192 + (i % 5) * 32, 256 - (i % 3) * 32);
+}
+
+int main() {
+    char label[96];
+    V4pPolygonP sprites[SPRITES];
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("instances");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP proto = newProto(), cloneProto = newProto();
+
+    // Clones first, transformed point by point
+    int differ = 0, frames = 0;
+    addSprites(cloneProto, false, sprites);
+    for (int frame = 0; frame < 8; frame++, frames++) {
+        moveSprites(sprites, frame);
+        v4p_render();
+        memcpy(clonePixels, pixels, sizeof(pixels));
+        v4p_clearScene();
+        addSprites(proto, true, sprites);
+        moveSprites(sprites, frame);
+        v4p_render();
+        if (memcmp(pixels, clonePixels, sizeof(pixels))) differ++;
+        v4p_clearScene();
+        addSprites(cloneProto, false, sprites);
+    }
+    snprintf(label, sizeof(label), "instances drawn like transformed clones (%d/%d frames differ)", differ, frames);
+    check(differ == 0, label);
+    v4p_clearScene();
+
+    // Instances keep following their moves and their prototype changes
+    addSprites(proto, true, sprites);
+    V4pPolygonP copy = v4p_addClone(sprites[5]);
+    check(copy != NULL && ! v4p_getPoints(copy), "clone of an instance is an instance");
+    moveSprites(sprites, 3);
+    v4p_transform(copy, 140, 90, 0, 0, 256, 256);
+    v4p_render();
+    check(v4p_pick(140, 94) == copy && v4p_pick(140, 80) == NULL && v4p_pick(148, 106) == NULL, "instance picked");
+    v4p_movePoint(proto, v4p_getPoints(proto), 10, 20);  // last added point
+    v4p_render();
+    check(v4p_pick(148, 106) == copy, "prototype change followed");
+    v4p_clearScene();
+
+    V4pPolygonP clones[SPRITES];
+    v4p_movePoint(cloneProto, v4p_getPoints(cloneProto), 10, 20);
+    addSprites(cloneProto, false, clones);
+    moveSprites(clones, 3);
+    v4p_render();
+    memcpy(clonePixels, pixels, sizeof(pixels));
+    v4p_clearScene();
+    addSprites(proto, true, sprites);
+    moveSprites(sprites, 3);
+    v4p_render();
+    check(! memcmp(pixels, clonePixels, sizeof(pixels)), "changed prototype drawn like clones");
+
+    // Subs of a same layer overlapping, listed and drawn in prototype order
+    v4p_clearScene();
+    V4pPolygonP pair = v4p_new(V4P_ABSOLUTE, V4P_BLUE, 20);
+    v4p_addCorners(pair, 0, 0, 40, 30);
+    v4p_addSub(pair, v4p_newDisk(V4P_ABSOLUTE, V4P_RED, 21, 15, 15, 10));
+    v4p_addSub(pair, v4p_newDisk(V4P_ABSOLUTE, V4P_GREEN, 21, 25, 15, 10));
+    V4pPolygonP pairClone = v4p_addClone(pair);
+    v4p_transform(pairClone, 30, 40, 0, 0, 256, 256);
+    v4p_render();
+    memcpy(clonePixels, pixels, sizeof(pixels));
+    v4p_clearScene();
+    V4pPolygonP pairInstance = v4p_addNewInstance(pair);
+    v4p_transform(pairInstance, 30, 40, 0, 0, 256, 256);
+    v4p_render();
+    V4pPolygonP first = v4p_getFirstSub(pairInstance);
+    check(v4p_getColor(first) == V4P_GREEN && v4p_getColor(v4p_getNextSub(first)) == V4P_RED,
+          "instance subs listed in prototype order");
+    check(! memcmp(pixels, clonePixels, sizeof(pixels)), "instance subs of a same layer drawn like clone subs");
+    v4p_clearScene();
+    v4p_destroy(pair);
+
+    addSprites(proto, true, sprites);
+    v4p_destroy(proto);
+    v4p_render();
+    int drawn = 0;
+    for (int i = 0; i < W * H; i++)
+        if (pixels[i] != V4P_BLACK) drawn++;
+    check(drawn == 0, "instances of a destroyed prototype left empty");
+
+    v4p_clearScene();
+    v4p_destroy(cloneProto);
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Instance test FAILED\n" : "Instance test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Instance test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
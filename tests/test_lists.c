@@ -0,0 +1,101 @@
+/**
+ * Test for scene and subs lists
+ * Polygons are removed from their list through their own link: removing the first, a middle or the last
+ * polygon of a scene or of a subs list, cloned ones included, must leave the others listed in order.
+ * Removing a polygon from a list not holding it must fail, leaving both lists untouched.
+ */
+#include "v4p.h"
+#include <stdio.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "check.h"
+
+#define N 6
+
+// Compare a list, from its first polygon, to expected polygons
+static bool listIs(V4pPolygonP first, V4pPolygonP* expected, int n) {
+    V4pPolygonP p = first;
+    for (int i = 0; i < n; i++, p = v4p_getNextSub(p))
+        if (p != expected[i]) return false;
+    return p == NULL;
+}
+
+int main() {
+    if (v4p_init()) return 1;
+    V4pSceneP s = v4p_newScene("lists");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+
+    // Scene list, last added polygon first
+    V4pPolygonP p[N];
+    for (int i = 0; i < N; i++) p[i] = v4p_addNew(V4P_ABSOLUTE, V4P_RED, i);
+    V4pPolygonP all[] = { p[5], p[4], p[3], p[2], p[1], p[0] };
+    check(listIs(s->polygons, all, N), "scene lists last added polygon first");
+    v4p_remove(p[5]);
+    v4p_remove(p[2]);
+    v4p_remove(p[0]);
+    V4pPolygonP left[] = { p[4], p[3], p[1] };
+    check(listIs(s->polygons, left, 3), "first, middle and last polygons removed from scene");
+    v4p_add(p[2]);
+    V4pPolygonP readded[] = { p[2], p[4], p[3], p[1] };
+    check(listIs(s->polygons, readded, 4), "removed polygon added again");
+    v4p_destroy(p[5]);
+    v4p_destroy(p[0]);
+
+    // Subs lists, of a polygon and of its clone
+    V4pPolygonP subs[N];
+    for (int i = 0; i < N; i++) subs[i] = v4p_addNewSub(p[3], V4P_ABSOLUTE, V4P_BLUE, 10 + i);
+    V4pPolygonP clone = v4p_addClone(p[3]);
+    V4pPolygonP cloned[N];
+    V4pPolygonP q = v4p_getFirstSub(clone);
+    for (int i = 0; i < N; i++, q = v4p_getNextSub(q)) cloned[i] = q;
+    check(q == NULL && cloned[N - 1] != NULL, "clone has as many subs");
+    v4p_destroyFromParent(p[3], subs[5]);
+    v4p_destroyFromParent(p[3], subs[3]);
+    v4p_destroyFromParent(clone, cloned[5]);
+    v4p_destroyFromParent(clone, cloned[0]);
+    v4p_destroyFromParent(clone, cloned[2]);
+    V4pPolygonP subsLeft[] = { subs[4], subs[2], subs[1], subs[0] };
+    V4pPolygonP clonedLeft[] = { cloned[1], cloned[3], cloned[4] };
+    check(listIs(v4p_getFirstSub(p[3]), subsLeft, 4), "subs destroyed from a polygon");
+    check(listIs(v4p_getFirstSub(clone), clonedLeft, 3), "subs destroyed from a clone");
+
+    V4pPolygonP scene[] = { clone, p[2], p[4], p[3], p[1] };
+    check(listIs(s->polygons, scene, 5), "scene left in order");
+
+    // Wrong lists
+    check(v4p_destroyFromParent(p[3], cloned[1]) == failure, "sub of another parent not destroyed");
+    check(listIs(v4p_getFirstSub(p[3]), subsLeft, 4), "parent subs untouched");
+    check(listIs(v4p_getFirstSub(clone), clonedLeft, 3), "other parent subs untouched");
+    check(v4p_destroyFromParent(p[3], p[4]) == failure, "scene polygon not destroyed as a sub");
+    V4pSceneP other = v4p_newScene("other");
+    V4pPolygonP stranger = v4p_sceneAddNewPoly(other, V4P_ABSOLUTE, V4P_GREEN, 0);
+    v4p_sceneRemove(other, p[4]);
+    v4p_sceneRemove(s, stranger);
+    V4pPolygonP strangers[] = { stranger };
+    check(listIs(s->polygons, scene, 5), "scene untouched");
+    check(listIs(other->polygons, strangers, 1), "other scene untouched");
+    v4p_sceneRemove(other, stranger);
+    check(other->polygons == NULL, "polygon removed from its own scene");
+    v4p_destroy(stranger);
+    v4p_destroyScene(other);
+    v4p_clearScene();
+    check(s->polygons == NULL, "scene cleared");
+
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4p_quit();
+
+    printf(errors ? "Lists test FAILED\n" : "Lists test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Lists test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
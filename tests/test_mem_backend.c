@@ -0,0 +1,77 @@
+/**
+ * Test for the headless in-memory backend
+ * Renders into the default buffer and into caller-supplied 8/32 bits buffers
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 64
+#define H 48
+#define STRIDE32 (W * 4 + 16)  // padded rows
+
+// Render a red square over a white background in the current display
+static void renderScene(V4pContextP c) {
+    v4p_setContext(c);
+    v4p_setView(0, 0, W, H);
+    v4p_setBGColor(V4P_WHITE);
+    V4pPolygonP p = v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1);
+    v4p_addCorners(p, 10, 10, 20, 20);
+    v4p_render();
+}
+
+int main() {
+    if (v4p_init()) return 1;
+
+    // Default context: 8 bits buffer owned by the backend
+    v4p_setBGColor(V4P_BLUE);
+    v4p_render();
+    int stride, bpp;
+    uint8_t* pixels = v4pi_getBuffer(v4pi_defaultContext, &stride, &bpp);
+    check(bpp == 8 && stride == v4p_displayWidth, "default buffer is packed 8 bits");
+    check(pixels[0] == V4P_BLUE && pixels[(v4p_displayHeight - 1) * stride + v4p_displayWidth - 1] == V4P_BLUE,
+          "default buffer filled with background");
+
+    // Caller-supplied 8 bits buffer
+    static uint8_t buffer8[W * H];
+    V4piContextP d8 = v4pi_newBufferContext(buffer8, W, H, 0, 8);
+    v4pi_setContext(d8);
+    V4pContextP c8 = v4p_newContext(v4p_newScene("mem8"));
+    renderScene(c8);
+    check(buffer8[0] == V4P_WHITE, "8 bits background pixel");
+    check(buffer8[15 * W + 15] == V4P_RED, "8 bits polygon pixel");
+    check(buffer8[15 * W + 25] == V4P_WHITE, "8 bits pixel right of polygon");
+
+    // Caller-supplied 32 bits buffer with padded stride
+    static uint32_t buffer32[STRIDE32 / 4 * H];
+    memset(buffer32, 0xAB, sizeof(buffer32));
+    V4piContextP d32 = v4pi_newBufferContext(buffer32, W, H, STRIDE32, 32);
+    v4pi_setContext(d32);
+    V4pContextP c32 = v4p_newContext(v4p_newScene("mem32"));
+    renderScene(c32);
+    uint32_t red = ((uint32_t) V4P_PALETTE_R(V4P_RED) << 16) | (V4P_PALETTE_G(V4P_RED) << 8) | V4P_PALETTE_B(V4P_RED);
+    check(buffer32[15 * (STRIDE32 / 4) + 15] == red, "32 bits polygon pixel");
+    check(buffer32[15 * (STRIDE32 / 4) + W] == 0xABABABAB, "32 bits row padding untouched");
+
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d8);
+    v4pi_destroyContext(d32);
+    v4p_setContext(v4p_defaultContext);
+    v4p_quit();
+
+    printf(errors ? "Memory backend test FAILED\n" : "Memory backend test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Memory backend test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * Test for the openable edge table kept across frames
+ * A same scene is edited in two contexts, the reference one rebuilding its table
+ * at each frame (view set again), pixels must match after each frame.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 100
+#define H 80
+
+// A scene rendered in its own buffer
+typedef struct {
+    uint8_t pixels[W * H];
+    V4piContextP display;
+    V4pContextP context;
+    V4pSceneP scene, other;
+    V4pPolygonP sprite, tree, sub, hud;
+    V4pCoord viewX, viewY;
+} Screen;
+
+static void select(Screen* s) {
+    v4pi_setContext(s->display);
+    v4p_setContext(s->context);
+}
+
+static void build(Screen* s) {
+    s->display = v4pi_newBufferContext(s->pixels, W, H, 0, 8);
+    v4pi_setContext(s->display);
+    s->scene = v4p_newScene("table");
+    s->other = v4p_newScene("other");
+    s->context = v4p_newContext(s->scene);
+    v4p_setContext(s->context);
+    v4p_setBGColor(V4P_BLACK);
+
+    for (int i = 0; i < 6; i++) {  // static map
+        v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, 10 + i, 1), i * 16, 40 + i * 5, i * 16 + 12, 75);
+    }
+    s->sprite = v4p_addNewDisk(V4P_ABSOLUTE, V4P_RED, 5, 20, 20, 8);
+    s->tree = v4p_addNew(V4P_ABSOLUTE, V4P_YELLOW, 2);
+    v4p_addCorners(s->tree, 50, 10, 90, 50);
+    s->sub = v4p_addNewSub(s->tree, V4P_ABSOLUTE, V4P_WHITE, 3);
+    v4p_addCorners(s->sub, 60, 20, 80, 40);
+    s->hud = v4p_addNew(V4P_RELATIVE, V4P_GREEN, 9);
+    v4p_addCorners(s->hud, 2, 2, 30, 8);
+    s->viewX = s->viewY = 0;
+
+    v4p_setScene(s->other);
+    v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), 10, 10, 90, 70);
+    v4p_setScene(s->scene);
+}
+
+static void destroy(Screen* s) {
+    select(s);
+    v4p_clearScene();
+    v4p_setScene(s->other);
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(s->context);
+    v4p_destroyScene(s->scene);
+    v4p_destroyScene(s->other);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(s->display);
+}
+
+static Screen kept, rebuilt;
+
+// Render both screens, the reference one from a rebuilt table, then compare pixels
+static void renderAndCompare(const char* what) {
+    char label[96];
+    select(&rebuilt);
+    v4p_setView(rebuilt.viewX, rebuilt.viewY, rebuilt.viewX + W, rebuilt.viewY + H);
+    v4p_render();
+    select(&kept);
+    v4p_render();
+    snprintf(label, sizeof(label), "%s: same pixels as with a rebuilt table", what);
+    check(! memcmp(kept.pixels, rebuilt.pixels, sizeof(kept.pixels)), label);
+}
+
+// Apply a same change to both screens
+#define BOTH(CHANGE) \
+    do { \
+        Screen* s = &kept; \
+        select(s); \
+        CHANGE; \
+        s = &rebuilt; \
+        select(s); \
+        CHANGE; \
+    } while (0)
+
+int main() {
+    if (v4p_init()) return 1;
+
+    build(&kept);
+    build(&rebuilt);
+
+    renderAndCompare("first frame");
+    renderAndCompare("no change");
+    check(kept.pixels[20 * W + 20] == V4P_RED, "sprite drawn");
+
+    for (int i = 0; i < 5; i++) {
+        BOTH(v4p_transform(s->sprite, 7, 9, 0, 0, 256, 256));
+        renderAndCompare("sprite moved");
+    }
+
+    BOTH(v4p_remove(s->sprite));
+    renderAndCompare("sprite removed");
+
+    BOTH(v4p_add(s->sprite));
+    renderAndCompare("same sprite added again");
+
+    BOTH(v4p_disable(s->tree));
+    renderAndCompare("tree disabled");
+
+    BOTH(v4p_enable(s->tree));
+    renderAndCompare("tree enabled");
+
+    BOTH(v4p_destroyFromParent(s->tree, s->sub));
+    renderAndCompare("sub destroyed");
+
+    BOTH(v4p_transform(s->hud, 0, 50, 0, 0, 256, 256));
+    renderAndCompare("relative polygon moved");
+
+    BOTH(v4p_setScene(s->other));
+    renderAndCompare("other scene");
+
+    BOTH(v4p_setScene(s->scene));
+    renderAndCompare("scene back");
+
+    BOTH(s->viewX = 13; s->viewY = 17; v4p_setView(s->viewX, s->viewY, s->viewX + W, s->viewY + H));
+    renderAndCompare("view moved, edges starting above it");
+
+    BOTH(v4p_transform(s->tree, -30, 0, 0, 0, 256, 256));
+    renderAndCompare("tree moved in moved view");
+
+    BOTH(v4p_transform(s->tree, 0, -8, 0, 0, 256, 256));
+    renderAndCompare("tree moved up, above the view");
+
+    BOTH(v4p_transform(s->sprite, 0, H, 0, 0, 256, 256));
+    renderAndCompare("sprite moved below the view");
+
+    destroy(&kept);
+    destroy(&rebuilt);
+    v4p_quit();
+
+    printf(errors ? "Openable table test FAILED\n" : "Openable table test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Openable table test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * Test for partial scene refresh
+ * A same scene is rendered with and without partial refresh while being edited,
+ * pixels must match after each frame and only changed rows must be drawn.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 120
+#define H 200
+
+// A scene rendered in its own buffer
+typedef struct {
+    uint8_t pixels[W * H];
+    V4piContextP display;
+    V4pContextP context;
+    V4pSceneP scene;
+    V4pPolygonP background, sprite, disk, tree, sub;
+} Screen;
+
+static void select(Screen* s) {
+    v4pi_setContext(s->display);
+    v4p_setContext(s->context);
+}
+
+static void build(Screen* s, bool partial) {
+    s->display = v4pi_newBufferContext(s->pixels, W, H, 0, 8);
+    v4pi_setContext(s->display);
+    s->scene = v4p_newScene("partial");
+    s->context = v4p_newContext(s->scene);
+    v4p_setContext(s->context);
+    check(v4p_setPartialRefresh(partial) == success, partial ? "partial refresh enabled" : "full refresh");
+    v4p_setBGColor(V4P_BLACK);
+
+    for (int i = 0; i < 8; i++) {  // static dashboard
+        V4pPolygonP p = v4p_addNew(V4P_ABSOLUTE, 10 + i, 1);
+        v4p_addCorners(p, 5 + i * 14, 5 + i * 20, 15 + i * 14, 40 + i * 20);
+    }
+    s->background = v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0);
+    v4p_addCorners(s->background, 0, 60, W, 140);
+    s->sprite = v4p_addNew(V4P_ABSOLUTE, V4P_RED, 5);
+    v4p_addPoint(s->sprite, 20, 20);
+    v4p_addPoint(s->sprite, 35, 25);
+    v4p_addPoint(s->sprite, 25, 38);
+    s->disk = v4p_addNewDisk(V4P_ABSOLUTE, V4P_GREEN, 3, 60, 170, 12);
+    s->tree = v4p_addNew(V4P_ABSOLUTE, V4P_YELLOW, 2);
+    v4p_addCorners(s->tree, 70, 100, 110, 130);
+    s->sub = v4p_addNewSub(s->tree, V4P_ABSOLUTE, V4P_WHITE, 4);
+    v4p_addCorners(s->sub, 80, 105, 100, 125);
+}
+
+static void destroy(Screen* s) {
+    select(s);
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(s->context);
+    v4p_destroyScene(s->scene);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(s->display);
+}
+
+static Screen partial, full;
+
+// Render both screens, then compare pixels and rows drawn by the partial one
+static void renderAndCompare(const char* what, int expectedMinY, int expectedMaxY) {
+    char label[96];
+    int y0, y1;
+    select(&full);
+    v4p_render();
+    select(&partial);
+    v4p_render();
+    v4pi_getDamage(partial.display, &y0, &y1);
+    snprintf(label, sizeof(label), "%s: same pixels as full refresh", what);
+    check(! memcmp(partial.pixels, full.pixels, sizeof(full.pixels)), label);
+    snprintf(label, sizeof(label), "%s: rows [%d, %d) drawn, within [%d, %d)", what, y0, y1, expectedMinY,
+             expectedMaxY);
+    check(y0 >= expectedMinY && y1 <= expectedMaxY, label);
+}
+
+// Apply a same change to both screens
+#define BOTH(CHANGE) \
+    do { \
+        Screen* s = &partial; \
+        select(s); \
+        CHANGE; \
+        s = &full; \
+        select(s); \
+        CHANGE; \
+    } while (0)
+
+int main() {
+    if (v4p_init()) return 1;
+
+    build(&partial, true);
+    build(&full, false);
+
+    renderAndCompare("first frame", 0, H);
+    int y0, y1;
+    v4pi_getDamage(partial.display, &y0, &y1);
+    check(y0 == 0 && y1 == H, "first frame draws all rows");
+
+    renderAndCompare("no change", 0, 0);
+    v4pi_getDamage(partial.display, &y0, &y1);
+    check(y0 == y1, "nothing drawn without change");
+
+    BOTH(v4p_transform(s->sprite, 0, 30, 0, 0, 256, 256));
+    renderAndCompare("sprite moved", 20, 69);
+
+    BOTH(v4p_setColor(s->disk, V4P_RED));
+    renderAndCompare("disk recolored", 158, 183);
+
+    BOTH(v4p_setLayer(s->background, 6));
+    renderAndCompare("background relayered", 60, 140);
+
+    BOTH(v4p_setVisibility(s->sub, false));
+    renderAndCompare("sub hidden", 105, 125);
+
+    BOTH(v4p_destroyFromScene(s->tree));
+    renderAndCompare("tree removed", 100, 130);
+
+    BOTH(s->tree = v4p_addNewDisk(V4P_ABSOLUTE, V4P_YELLOW, 7, 30, 180, 8));
+    renderAndCompare("disk added", 172, 189);
+
+    BOTH(v4p_transform(s->disk, 0, -150, 0, 0, 256, 256));
+    renderAndCompare("disk moved up", 8, 183);
+
+    BOTH(v4p_setBGColor(V4P_WHITE));
+    renderAndCompare("background color", 0, H);
+
+    BOTH(v4p_setView(10, 10, W + 10, H + 10));
+    renderAndCompare("view moved", 0, H);
+
+    BOTH(v4p_transform(s->sprite, 5, 0, 0, 0, 256, 256));
+    renderAndCompare("sprite moved in moved view", 40, 59);
+
+    destroy(&partial);
+    destroy(&full);
+    v4p_quit();
+
+    printf(errors ? "Partial refresh test FAILED\n" : "Partial refresh test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Partial refresh test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
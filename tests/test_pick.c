@@ -0,0 +1,113 @@
+/**
+ * Test for polygon picking
+ * The polygon picked at each display point must be the one whose color was drawn there,
+ * whatever the shapes, strokes, subs, zoom or grid, and without rendering a frame.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "pick.h"
+
+#define W 100
+#define H 80
+
+static uint8_t pixels[W * H];
+
+int main() {
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("pick");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP ground = v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0);
+    v4p_addCorners(ground, -50, 50, 150, 70);
+    v4p_setCollisionMask(ground, 1);
+    V4pPolygonP slope = v4p_addNew(V4P_ABSOLUTE, 20, 1);
+    v4p_addPoint(slope, 5, 5);
+    v4p_addPoint(slope, 60, 12);
+    v4p_addPoint(slope, 17, 58);
+    V4pPolygonP disk = v4p_addNewDisk(V4P_ABSOLUTE, V4P_RED, 3, 40, 40, 17);
+    v4p_setCollisionMask(disk, 2);
+    V4pPolygonP ring = v4p_addNewDisk(V4P_ABSOLUTE, 30, 4, 70, 25, 12);
+    v4p_setStroke(ring, 1);
+    V4pPolygonP frame = v4p_addNew(V4P_ABSOLUTE, 31, 2);
+    v4p_addCorners(frame, 52, 40, 90, 75);
+    v4p_setStroke(frame, 1);
+    V4pPolygonP car = v4p_addNew(V4P_ABSOLUTE, V4P_YELLOW, 2);
+    v4p_addCorners(car, 20, 45, 70, 62);
+    V4pPolygonP wheel = v4p_addNewSub(car, V4P_ABSOLUTE, V4P_WHITE, 5);
+    v4p_addCorners(wheel, 25, 55, 35, 65);
+    V4pPolygonP twin = v4p_addNew(V4P_ABSOLUTE, 40, 3);  // same layer as the disk
+    v4p_addCorners(twin, 45, 30, 65, 48);
+    V4pPolygonP hud = v4p_addNew(V4P_RELATIVE, V4P_GREEN, 9);
+    v4p_addCorners(hud, 2, 2, 30, 8);
+    v4p_setCollisionMask(hud, 2);
+
+    V4pPolygonP picked[8];
+    checkPicks("first frame", pixels, W, H);
+    check(v4p_pick(40, 40) == disk, "disk picked at its center");
+    check(v4p_pick(48, 35) == disk && v4p_pickAll(48, 35, picked, 8) == 2 && picked[1] == twin,
+          "polygons of a same layer picked in drawing order");
+    check(v4p_pick(-1, 10) == NULL && v4p_pick(W, 10) == NULL && v4p_pick(10, H) == NULL, "nothing out of display");
+    check(v4p_pickMasked(40, 40, 1) == NULL, "masked pick skips unmasked polygons");
+    check(v4p_pickMasked(30, 56, 3) == ground, "masked pick finds the polygon below");
+    check(v4p_pickMasked(10, 5, 2) == hud && v4p_pickMasked(10, 5, 4) == NULL, "masked pick honors mask bits");
+    int n = v4p_pickAll(30, 58, picked, 8);
+    check(n == 3 && picked[0] == wheel && picked[1] == car && picked[2] == ground, "all polygons picked topmost first");
+    check(v4p_pickAll(30, 58, picked, 2) == 2 && picked[0] == wheel && picked[1] == car, "picked polygons bounded");
+
+    // Picking does not render: changes show at next frame only
+    memset(pixels, V4P_WHITE, W);
+    v4p_transform(disk, 30, 0, 0, 0, 256, 256);
+    check(v4p_pick(40, 40) == disk && pixels[0] == V4P_WHITE, "moved polygon picked as drawn");
+    v4p_invalidate();  // scribbled row
+    checkPicks("disk moved", pixels, W, H);
+    check(v4p_pick(70, 40) == disk, "moved polygon picked at its new place");
+
+    v4p_disable(twin);
+    checkPicks("twin disabled", pixels, W, H);
+
+    v4p_transform(car, 0, 100, 0, 0, 256, 256);
+    checkPicks("car out of view", pixels, W, H);
+    check(v4p_pick(30, 58) != wheel, "culled wheel not picked");
+
+    v4p_setView(-20, -10, 180, 150);
+    checkPicks("view zoomed out", pixels, W, H);
+
+    v4p_setView(30, 20, 80, 60);
+    checkPicks("view zoomed in", pixels, W, H);
+
+    check(v4p_setSceneGrid(s, 16) == success, "grid set");
+    v4p_setView(0, 0, W, H);
+    v4p_transform(car, 0, -100, 0, 0, 256, 256);
+    checkPicks("gridded scene", pixels, W, H);
+    v4p_setView(40, 0, W + 40, H);
+    checkPicks("gridded scene scrolled", pixels, W, H);
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Pick test FAILED\n" : "Pick test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Pick test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * Test for polygon points
+ * Points are listed from the last added one, whether they are linked or packed in one array (make PACKED=1),
+ * and a polygon whose points were moved or removed must be drawn like one built with its remaining points.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 80
+#define H 60
+
+static uint8_t pixels[W * H], builtPixels[W * H];
+
+// Compare the points of a polygon, listed from the last added one, to coordinates
+static bool pointsAre(V4pPolygonP p, const V4pCoord* xy, int n) {
+    V4pPointP s = v4p_getPoints(p);
+    for (int i = 0; i < n; i++, s = v4p_nextPoint(s))
+        if (! s || s->x != xy[2 * i] || s->y != xy[2 * i + 1]) return false;
+    return s == NULL;
+}
+
+// Nth point of a polygon, from the last added one
+static V4pPointP nthPoint(V4pPolygonP p, int n) {
+    V4pPointP s = v4p_getPoints(p);
+    while (n--) s = v4p_nextPoint(s);
+    return s;
+}
+
+int main() {
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("points");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP p = v4p_addNew(V4P_ABSOLUTE, V4P_GREEN, 0);
+    check(v4p_getPoints(p) == NULL, "new polygon has no point");
+    for (int i = 0; i < 40; i++) v4p_addPoint(p, 10 + i, 5 + (i % 2) * 40);  // enough to grow any array
+    bool ordered = true;
+    int n = 0;
+    for (V4pPointP q = v4p_getPoints(p); q; q = v4p_nextPoint(q), n++)
+        if (q->x != 49 - n || q->y != 5 + ((39 - n) % 2) * 40) ordered = false;
+    check(ordered && n == 40, "points listed from the last added one");
+
+    v4p_destroyPointFrom(p, v4p_getPoints(p));  // last added
+    v4p_destroyPointFrom(p, nthPoint(p, 38));   // first added
+    while (v4p_getPoints(p) && v4p_nextPoint(v4p_nextPoint(v4p_nextPoint(v4p_getPoints(p)))))
+        v4p_destroyPointFrom(p, nthPoint(p, 1));
+    const V4pCoord left[] = { 48, 5, 12, 5, 11, 45 };
+    check(pointsAre(p, left, 3), "first, middle and last points removed");
+
+    v4p_movePoint(p, nthPoint(p, 1), 70, 50);
+    const V4pCoord moved[] = { 48, 5, 70, 50, 11, 45 };
+    check(pointsAre(p, moved, 3), "point moved");
+    v4p_render();
+    memcpy(builtPixels, pixels, sizeof(pixels));
+
+    v4p_clearScene();
+    V4pPolygonP q = v4p_addNew(V4P_ABSOLUTE, V4P_GREEN, 0);
+    for (int i = 2; i >= 0; i--) v4p_addPoint(q, moved[2 * i], moved[2 * i + 1]);
+    v4p_render();
+    int drawn = 0;
+    for (int i = 0; i < W * H; i++)
+        if (pixels[i] != V4P_BLACK) drawn++;
+    check(drawn > 0 && ! memcmp(pixels, builtPixels, sizeof(pixels)), "edited polygon drawn like a built one");
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Points test FAILED\n" : "Points test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Points test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
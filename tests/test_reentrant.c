@@ -0,0 +1,118 @@
+/**
+ * Test for re-entrancy: one context per thread
+ * Each thread renders its own scene (rotated clones, collisions) into its own buffer,
+ * results must match the same scenes rendered one after the other.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+#ifdef V4P_THREADS
+#include <pthread.h>
+#endif
+
+#define W 96
+#define H 64
+#define JOBS 4
+#define ROUNDS 50
+
+typedef struct {
+    int id;
+    uint8_t pixels[W * H];
+    int collisions;
+} Job;
+
+// Collisions counted per thread, through the context callback
+static V4P_TLS int collisions = 0;
+
+static void onCollision(V4pCollisionLayer i1, V4pCollisionLayer i2, V4pCoord py, V4pCoord x1, V4pCoord x2,
+                        V4pPolygonP p1, V4pPolygonP p2) {
+    (void) i1, (void) i2, (void) py, (void) x1, (void) x2, (void) p1, (void) p2;  // Only counted
+    collisions++;
+}
+
+// Render a scene of its own, many times, in its own contexts
+static void* runJob(void* arg) {
+    Job* job = (Job*) arg;
+    V4piContextP d = v4pi_newBufferContext(job->pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("job");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setCollisionCallback(onCollision);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP proto = v4p_new(V4P_ABSOLUTE, V4P_RED, 1);
+    v4p_addCorners(proto, -10, -6, 10, 6);
+    V4pPolygonP clones[3];
+    for (int i = 0; i < 3; i++) {
+        clones[i] = v4p_addClone(proto);
+        v4p_setCollisionMask(clones[i], 1 << i);
+    }
+
+    collisions = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < 3; i++) {
+            v4p_transformClone(proto, clones[i], 30 + i * 15 + job->id * 3, 32, job->id * 40 + i * 30 + round,
+                               i, 256 + job->id * 32, 256);
+        }
+        v4p_render();
+    }
+    job->collisions = collisions;
+
+    v4p_clearScene();
+    v4p_destroy(proto);
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    return NULL;
+}
+
+int main() {
+    static Job serial[JOBS], parallel[JOBS];
+
+    if (v4p_init()) return 1;
+
+    for (int i = 0; i < JOBS; i++) {
+        serial[i].id = parallel[i].id = i;
+        runJob(&serial[i]);
+    }
+    check(serial[0].collisions > 0, "scenes have collisions");
+
+#ifdef V4P_THREADS
+    pthread_t threads[JOBS];
+    for (int i = 0; i < JOBS; i++) pthread_create(&threads[i], NULL, runJob, &parallel[i]);
+    for (int i = 0; i < JOBS; i++) pthread_join(threads[i], NULL);
+#else
+    printf("Built without THREADS=1, jobs run serially\n");
+    for (int i = 0; i < JOBS; i++) runJob(&parallel[i]);
+#endif
+
+    for (int i = 0; i < JOBS; i++) {
+        char what[64];
+        snprintf(what, sizeof(what), "job %d: same pixels as serial render", i);
+        check(! memcmp(serial[i].pixels, parallel[i].pixels, sizeof(serial[i].pixels)), what);
+        snprintf(what, sizeof(what), "job %d: same collisions as serial render", i);
+        check(serial[i].collisions == parallel[i].collisions, what);
+    }
+    check(memcmp(serial[0].pixels, serial[1].pixels, sizeof(serial[0].pixels)), "jobs render distinct scenes");
+
+    v4p_quit();
+
+    printf(errors ? "Re-entrancy test FAILED\n" : "Re-entrancy test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Re-entrancy test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * Test for render statistics
+ * Counters are checked when built with STATS=1 or STATS=2, otherwise they must stay at zero
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include "check.h"
+
+int main() {
+    if (v4p_init()) return 1;
+    v4p_setBGColor(V4P_BLACK);
+
+    // Two overlapping squares (4 non-horizontal edges in total)
+    V4pPolygonP a = v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1);
+    v4p_addCorners(a, 10, 10, 50, 50);
+    V4pPolygonP b = v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 2);
+    v4p_addCorners(b, 30, 30, 70, 70);
+
+    v4p_resetRenderStats();
+    v4p_render();
+    v4p_render();
+    const V4pRenderStats* st = v4p_getRenderStats();
+
+#if defined(V4P_STATS) && V4P_STATS >= 1
+    check(st->frames == 2, "2 frames counted");
+    check(st->edgesBuilt == 4, "4 edges built once");
+    check(st->edgesOpened == 8 && st->edgesClosed == 8, "4 edges opened and closed per frame");
+    check(st->depthInserts == st->depthDeletes && st->depthInserts == 2 * (40 + 40), "1 depth insert per polygon row");
+    // rows drawn alike at the second frame may be skipped (backends built with V4PI_PARTIAL)
+    check(st->slices + st->rowsSkipped >= 2 * (uint32_t) v4p_displayHeight, "at least 1 slice or skip per row");
+    #if V4P_STATS >= 2
+    check(st->totalTime > 0 && st->totalTime >= st->sliceTime, "render timings collected");
+    #endif
+#else
+    check(st->frames == 0 && st->slices == 0 && st->totalTime == 0, "stats disabled: counters stay at zero");
+#endif
+
+    v4p_quit();
+    printf(errors ? "Render stats test FAILED\n" : "Render stats test completed successfully!\n");
+    return errors ? 1 : 0;
+}
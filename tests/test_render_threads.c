@@ -0,0 +1,106 @@
+/**
+ * Test for multi-threaded banded rendering
+ * Renders a same scene serially then in parallel bands and compares pixels and collisions
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 160
+#define H 240
+#define MAX_COLLISIONS 8192
+
+// Collisions in reporting order
+// Empty ones are ignored: edges of same x may be met in another order at the top of a band
+typedef struct {
+    V4pCollisionLayer i1, i2;
+    V4pCoord y, x1, x2;
+} Collision;
+
+static Collision collisions[MAX_COLLISIONS];
+static int collisionsNb = 0;
+
+static void onCollision(V4pCollisionLayer i1, V4pCollisionLayer i2, V4pCoord py, V4pCoord x1, V4pCoord x2,
+                        V4pPolygonP p1, V4pPolygonP p2) {
+    (void) p1, (void) p2;  // Compared by layers
+    if (collisionsNb == MAX_COLLISIONS || x2 <= x1) return;
+    Collision c = { i1, i2, py, x1, x2 };
+    collisions[collisionsNb++] = c;
+}
+
+// Render overlapping shapes crossing band limits and the top of the view
+static int renderScene(uint8_t* buffer, int threads) {
+    V4piContextP d = v4pi_newBufferContext(buffer, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("threads");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    int used = v4p_setRenderThreads(threads);
+    v4p_setView(0, 0, W, H);
+    v4p_setBGColor(V4P_WHITE);
+
+    for (int i = 0; i < 12; i++) {
+        V4pPolygonP p = v4p_addNew(V4P_ABSOLUTE, 1 + i * 7, i);
+        v4p_addPoint(p, 10 + i * 11, -30 + i * 5);
+        v4p_addPoint(p, 70 + i * 7, 20 + i * 19);
+        v4p_addPoint(p, 30 + i * 3, 130 + i * 9);
+        v4p_setCollisionMask(p, 1 << (i & 3));
+        V4pPolygonP disk = v4p_addNewDisk(V4P_ABSOLUTE, 100 + i, 20 + i, 20 + i * 10, i * 20, 8 + i * 2);
+        if (i & 1) v4p_setStroke(disk, 1);
+    }
+
+    collisionsNb = 0;
+    v4p_render();
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    return used;
+}
+
+int main() {
+    static uint8_t serial[W * H], parallel[W * H];
+    static Collision serialCollisions[MAX_COLLISIONS];
+
+    if (v4p_init()) return 1;
+    v4p_setCollisionCallback(onCollision);
+
+    check(renderScene(serial, 1) == 1, "serial render uses 1 thread");
+    int serialCollisionsNb = collisionsNb;
+    memcpy(serialCollisions, collisions, sizeof(Collision) * collisionsNb);
+    check(serialCollisionsNb > 0, "scene has collisions");
+
+    for (int threads = 2; threads <= 8; threads *= 2) {
+        char what[80];
+        int used = renderScene(parallel, threads);
+        snprintf(what, sizeof(what), "%d threads requested, %d in use", threads, used);
+        check(used >= 1 && used <= threads, what);
+        snprintf(what, sizeof(what), "%d threads: same pixels as serial render", threads);
+        check(! memcmp(serial, parallel, sizeof(serial)), what);
+        snprintf(what, sizeof(what), "%d threads: same collisions in same order", threads);
+        check(collisionsNb == serialCollisionsNb
+                  && ! memcmp(serialCollisions, collisions, sizeof(Collision) * collisionsNb),
+              what);
+    }
+
+    v4p_quit();
+
+    printf(errors ? "Render threads test FAILED\n" : "Render threads test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Render threads test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Test for the drawn rows cache
+ * Rows looking the same as at previous frame must not be drawn again,
+ * while changed rows must match a render from scratch, as well as rows another context drew over.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 80
+#define H 60
+
+static uint8_t pixels[W * H], expected[W * H];
+
+// Render the sprite at (x, y) from scratch, in a buffer and contexts of its own
+static void renderFromScratch(V4pCoord x, V4pCoord y, V4piContextP display, V4pContextP context) {
+    V4piContextP d = v4pi_newBufferContext(expected, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("scratch");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+    v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), 0, 40, W, H);
+    v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1), x, y, x + 10, y + 10);
+    v4p_render();
+    v4p_clearScene();
+    v4p_setContext(context);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(display);
+    v4pi_destroyContext(d);
+}
+
+int main() {
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("cache");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+    v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0), 0, 40, W, H);
+    V4pPolygonP sprite = v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1);
+    v4p_addCorners(sprite, 10, 10, 20, 20);
+
+    v4p_render();
+    renderFromScratch(10, 10, d, c);
+    check(! memcmp(pixels, expected, sizeof(pixels)), "first frame drawn");
+
+    // Scribble on a row, an unchanged frame must leave it as is
+    memset(pixels + 5 * W, V4P_WHITE, W);
+    v4p_render();
+    check(pixels[5 * W + 40] == V4P_WHITE, "unchanged row not drawn again");
+
+    // Moving the sprite draws its old and new rows
+    v4p_transform(sprite, 0, 20, 0, 0, 256, 256);
+    v4p_render();
+    renderFromScratch(10, 30, d, c);
+    check(! memcmp(pixels + 10 * W, expected + 10 * W, (H - 10) * W), "changed rows drawn");
+    check(pixels[5 * W + 40] == V4P_WHITE, "unchanged row still not drawn");
+
+    // Invalidation draws every row
+    v4p_invalidate();
+    v4p_render();
+    check(! memcmp(pixels, expected, sizeof(pixels)), "all rows drawn after v4p_invalidate()");
+
+    // Another context drawing to the same display, rows it drew over are drawn again
+    V4pSceneP otherScene = v4p_newScene("other");
+    V4pContextP other = v4p_newContext(otherScene);
+    v4p_setContext(other);
+    v4p_setBGColor(V4P_GREEN);
+    v4p_render();
+    v4p_setContext(c);
+    v4p_render();
+    check(! memcmp(pixels, expected, sizeof(pixels)), "all rows drawn after another context drew");
+    memset(pixels + 5 * W, V4P_WHITE, W);
+    v4p_render();
+    check(pixels[5 * W + 40] == V4P_WHITE, "unchanged row not drawn again after that");
+    v4p_destroyContext(other);
+    v4p_destroyScene(otherScene);
+
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Row cache test FAILED\n" : "Row cache test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Row cache test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * Test for the scene grid
+ * A same world, wider than the view, is rendered from a gridded scene and from a plain one
+ * while being edited and scrolled, pixels must match after each frame, and polygons far
+ * from the view must not be visited at all.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#define V4P_DEBUG_ADDON  // Define this to allow including _v4p.h (edges inspection)
+#include "_v4p.h"
+#include "check.h"
+
+#define W 100
+#define H 80
+#define CELL 32
+
+// A world rendered in its own buffer
+typedef struct {
+    uint8_t pixels[W * H];
+    V4piContextP display;
+    V4pContextP context;
+    V4pSceneP scene;
+    V4pPolygonP sprite, twin, tree, sub, hud, ground, far;
+    V4pCoord viewX, viewY;
+} Screen;
+
+static void use(Screen* s) {
+    v4pi_setContext(s->display);
+    v4p_setContext(s->context);
+}
+
+static void build(Screen* s, bool gridded) {
+    s->display = v4pi_newBufferContext(s->pixels, W, H, 0, 8);
+    v4pi_setContext(s->display);
+    s->scene = v4p_newScene(gridded ? "grid" : "plain");
+    s->context = v4p_newContext(s->scene);
+    v4p_setContext(s->context);
+    v4p_setBGColor(V4P_BLACK);
+
+    s->ground = v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 0);  // much larger than cells
+    v4p_addCorners(s->ground, -500, 60, 1000, 70);
+    for (int i = 0; i < 40; i++) {  // tiles of a same layer, overlapping each other
+        V4pCoord x = (i % 10) * 45 - 100, y = (i / 10) * 50 - 60;
+        v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, 10 + i, 1), x, y, x + 30, y + 30);
+        v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, 60 + i, 1), x + 20, y + 10, x + 50, y + 40);
+    }
+    for (int i = 0; i < 1200; i++) {  // stars, crowding the grid
+        V4pCoord x = (i % 40) * 9 - 60, y = (i / 40) * 7 - 50;
+        v4p_addCorners(v4p_addNew(V4P_ABSOLUTE, 100 + i % 50, 0), x, y, x + 3, y + 3);
+    }
+    s->sprite = v4p_addNewDisk(V4P_ABSOLUTE, V4P_RED, 5, 20, 20, 8);
+    s->twin = v4p_addNewDisk(V4P_ABSOLUTE, V4P_GREEN, 5, 26, 20, 8);  // same layer as the sprite
+    s->tree = v4p_addNew(V4P_ABSOLUTE, V4P_YELLOW, 2);
+    v4p_addCorners(s->tree, 50, 10, 90, 50);
+    s->sub = v4p_addNewSub(s->tree, V4P_ABSOLUTE, V4P_WHITE, 3);
+    v4p_addCorners(s->sub, 60, 20, 80, 40);
+    s->hud = v4p_addNew(V4P_RELATIVE, V4P_GREEN, 9);
+    v4p_addCorners(s->hud, 2, 2, 30, 8);
+    s->far = v4p_addNew(V4P_ABSOLUTE, V4P_WHITE, 4);
+    v4p_addCorners(s->far, 5000, 5000, 5010, 5010);
+    s->viewX = s->viewY = 0;
+    if (gridded) check(v4p_setSceneGrid(s->scene, CELL) == success, "grid set");
+}
+
+static void destroy(Screen* s) {
+    use(s);
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(s->context);
+    v4p_destroyScene(s->scene);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(s->display);
+}
+
+static Screen gridded, plain;
+
+static void renderAndCompare(const char* what) {
+    char label[96];
+    use(&plain);
+    v4p_render();
+    use(&gridded);
+    v4p_render();
+    snprintf(label, sizeof(label), "%s: same pixels as without grid", what);
+    check(! memcmp(gridded.pixels, plain.pixels, sizeof(gridded.pixels)), label);
+}
+
+// Apply a same change to both screens
+#define BOTH(CHANGE) \
+    do { \
+        Screen* s = &gridded; \
+        use(s); \
+        CHANGE; \
+        s = &plain; \
+        use(s); \
+        CHANGE; \
+    } while (0)
+
+#define SCROLL(DX, DY) \
+    BOTH(s->viewX += (DX); s->viewY += (DY); v4p_setView(s->viewX, s->viewY, s->viewX + W, s->viewY + H))
+
+int main() {
+    if (v4p_init()) return 1;
+
+    build(&gridded, true);
+    build(&plain, false);
+
+    renderAndCompare("first frame");
+    check(gridded.pixels[20 * W + 14] == V4P_RED && gridded.pixels[20 * W + 30] == V4P_GREEN, "sprites drawn");
+    check(gridded.far->props & V4P_CHANGED, "far polygon not visited");
+    check(! (plain.far->props & V4P_CHANGED), "far polygon visited without grid");
+
+    for (int i = 0; i < 6; i++) {
+        BOTH(v4p_transform(s->sprite, 23, 7, 0, 0, 256, 256));
+        renderAndCompare("sprite moved across cells");
+    }
+    check(! gridded.sprite->ActiveEdge1, "sprite out of view, its edges freed");
+
+    BOTH(v4p_transform(s->sprite, -138, -42, 0, 0, 256, 256));
+    renderAndCompare("sprite back");
+    check(gridded.sprite->ActiveEdge1 != NULL, "sprite edges built again");
+
+    for (int i = 0; i < 8; i++) {
+        SCROLL(37, 11);
+        renderAndCompare("view scrolled");
+    }
+    check(! gridded.tree->ActiveEdge1 && ! gridded.sub->ActiveEdge1, "tree out of view, its edges freed");
+
+    SCROLL(-296, -88);
+    renderAndCompare("view back");
+
+    BOTH(v4p_setView(-400, -300, 600, 500));
+    renderAndCompare("view zoomed out over many cells");
+
+    BOTH(v4p_setView(s->viewX, s->viewY, s->viewX + W, s->viewY + H));
+    renderAndCompare("view zoomed in back");
+
+    BOTH(v4p_remove(s->twin));
+    renderAndCompare("twin removed");
+
+    BOTH(v4p_add(s->twin));
+    renderAndCompare("twin added again, now over the sprite");
+
+    BOTH(v4p_transform(s->tree, 0, 0, 0, 0, 256, 256); v4p_destroyFromScene(s->tree));
+    renderAndCompare("tree changed then destroyed");
+
+    BOTH(v4p_transform(s->far, -4980, -4980, 0, 0, 256, 256));
+    renderAndCompare("far polygon moved into view");
+
+    check(v4p_setSceneGrid(gridded.scene, 0) == success, "grid dropped");
+    renderAndCompare("grid dropped");
+
+    check(v4p_setSceneGrid(gridded.scene, 12) == success, "smaller grid set");
+    BOTH(v4p_transform(s->sprite, 3, 3, 0, 0, 256, 256));
+    renderAndCompare("smaller grid");
+
+    destroy(&gridded);
+    destroy(&plain);
+    v4p_quit();
+
+    printf(errors ? "Scene grid test FAILED\n" : "Scene grid test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Scene grid test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
@@ -16,15 +16,14 @@ int intDataPrior(void* a, void* b) {
 
 int main() {
     List demo = NULL, orderedList;
+    QuickHeap heap = QuickHeapNewFor(struct sList);
 
     // Seed random number generator
     srand(time(NULL));
 
-    ListSetCompareFunc(intDataPrior);
-
     // create a random list of integers
     for (int i = 0; i < 1000; i++) {
-        List n = ListNew();
+        List n = ListNewIn(heap);
 
         ListSetNext(n, demo);
 
@@ -38,7 +37,7 @@ int main() {
     }
 
     printf("Sorting list of 1000 random integers...\n");
-    orderedList = ListSort(demo);
+    orderedList = ListSort(demo, intDataPrior);
 
     // Verify the list is sorted in descending order
     int errors = 0;
@@ -78,8 +77,9 @@ int main() {
     // Clean up
     while (orderedList) {
         free(ListData(orderedList));
-        orderedList = ListFree(orderedList);
+        orderedList = ListFreeIn(heap, orderedList);
     }
+    QuickHeapDestroy(heap);
 
     return errors > 0 ? 1 : 0;
 }
\ No newline at end of file
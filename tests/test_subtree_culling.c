@@ -0,0 +1,160 @@
+/**
+ * Test for subtree culling
+ * A car (body, window, wheel holding a hub) is rendered as a polygon tree, and as
+ * the same polygons at scene level. Pixels must match while the car or its parts go out
+ * of the view and back, and culled subtrees must have their active edges freed.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#define V4P_DEBUG_ADDON  // Define this to allow including _v4p.h (edges inspection)
+#include "_v4p.h"
+#include "check.h"
+
+#define W 100
+#define H 80
+
+enum { BODY, WINDOW, WHEEL, HUB, PARTS };
+
+// A car rendered in its own buffer
+typedef struct {
+    uint8_t pixels[W * H];
+    V4piContextP display;
+    V4pContextP context;
+    V4pSceneP scene;
+    V4pPolygonP parts[PARTS];
+} Screen;
+
+static void use(Screen* s) {
+    v4pi_setContext(s->display);
+    v4p_setContext(s->context);
+}
+
+static void build(Screen* s, bool tree) {
+    s->display = v4pi_newBufferContext(s->pixels, W, H, 0, 8);
+    v4pi_setContext(s->display);
+    s->scene = v4p_newScene(tree ? "tree" : "flat");
+    s->context = v4p_newContext(s->scene);
+    v4p_setContext(s->context);
+    v4p_setBGColor(V4P_BLACK);
+
+    V4pPolygonP* p = s->parts;
+    p[BODY] = v4p_addNew(V4P_ABSOLUTE, V4P_RED, 1);
+    v4p_addCorners(p[BODY], 10, 30, 60, 50);
+    p[WINDOW] = tree ? v4p_addNewSub(p[BODY], V4P_ABSOLUTE, V4P_BLUE, 2) : v4p_addNew(V4P_ABSOLUTE, V4P_BLUE, 2);
+    v4p_addCorners(p[WINDOW], 30, 20, 50, 32);
+    p[WHEEL] = tree ? v4p_addNewSub(p[BODY], V4P_ABSOLUTE, V4P_WHITE, 3) : v4p_addNew(V4P_ABSOLUTE, V4P_WHITE, 3);
+    v4p_addCorners(p[WHEEL], 15, 45, 27, 57);
+    p[HUB] = tree ? v4p_addNewSub(p[WHEEL], V4P_ABSOLUTE, V4P_YELLOW, 4) : v4p_addNew(V4P_ABSOLUTE, V4P_YELLOW, 4);
+    v4p_addCorners(p[HUB], 19, 49, 23, 53);
+}
+
+static void destroy(Screen* s) {
+    use(s);
+    v4p_clearScene();
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(s->context);
+    v4p_destroyScene(s->scene);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(s->display);
+}
+
+static Screen tree, flat;
+
+static void renderAndCompare(const char* what) {
+    char label[96];
+    use(&flat);
+    v4p_render();
+    use(&tree);
+    v4p_render();
+    snprintf(label, sizeof(label), "%s: same pixels as flat polygons", what);
+    check(! memcmp(tree.pixels, flat.pixels, sizeof(tree.pixels)), label);
+}
+
+// Move a part (and its subs in the tree) in both screens
+static void move(int from, int to, V4pCoord dx, V4pCoord dy) {
+    use(&tree);
+    v4p_transform(tree.parts[from], dx, dy, 0, 0, 256, 256);
+    use(&flat);
+    for (int i = from; i <= to; i++) v4p_transform(flat.parts[i], dx, dy, 0, 0, 256, 256);
+}
+
+static bool edgesFreed(int from, int to) {
+    for (int i = from; i <= to; i++)
+        if (tree.parts[i]->ActiveEdge1) return false;
+    return true;
+}
+
+int main() {
+    if (v4p_init()) return 1;
+
+    build(&tree, true);
+    build(&flat, false);
+
+    renderAndCompare("first frame");
+    check(! edgesFreed(BODY, HUB), "visible car has edges");
+
+    move(BODY, HUB, 200, 0);
+    renderAndCompare("car out of view");
+    check(tree.parts[BODY]->props & V4P_CULLED, "car culled");
+    check(edgesFreed(BODY, HUB), "culled car edges freed");
+
+    move(WINDOW, WINDOW, -200, 0);
+    renderAndCompare("window back in view");
+    check(! edgesFreed(WINDOW, WINDOW), "window edges built again");
+    check(edgesFreed(WHEEL, HUB), "wheel edges still freed");
+
+    move(WINDOW, WINDOW, 200, 0);
+    move(BODY, HUB, -200, 0);
+    renderAndCompare("car back in view");
+    check(! (tree.parts[BODY]->props & V4P_CULLED), "car not culled anymore");
+    check(! edgesFreed(BODY, HUB), "car edges built again");
+
+    move(WHEEL, HUB, 0, 100);
+    renderAndCompare("wheel out of view");
+    check(tree.parts[WHEEL]->props & V4P_CULLED, "wheel culled alone");
+    check(edgesFreed(WHEEL, HUB) && ! edgesFreed(BODY, WINDOW), "only wheel edges freed");
+
+    use(&tree);
+    v4p_setView(0, 0, W / 2, H / 2);
+    use(&flat);
+    v4p_setView(0, 0, W / 2, H / 2);
+    move(WHEEL, HUB, 0, -100);
+    renderAndCompare("view zoomed, wheel back");
+
+    use(&tree);
+    v4p_setView(W, 0, 2 * W, H);
+    use(&flat);
+    v4p_setView(W, 0, 2 * W, H);
+    renderAndCompare("view moved away from the car");
+    check(edgesFreed(BODY, HUB), "car edges freed");
+
+    use(&tree);
+    v4p_destroyFromParent(tree.parts[WHEEL], tree.parts[HUB]);
+    use(&flat);
+    v4p_destroyFromScene(flat.parts[HUB]);
+    use(&tree);
+    v4p_setView(0, 0, W, H);
+    use(&flat);
+    v4p_setView(0, 0, W, H);
+    renderAndCompare("hub destroyed, view back");
+
+    destroy(&tree);
+    destroy(&flat);
+    v4p_quit();
+
+    printf(errors ? "Subtree culling test FAILED\n" : "Subtree culling test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Subtree culling test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
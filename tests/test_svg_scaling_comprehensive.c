@@ -35,7 +35,7 @@ int main() {
             if (current->x > max_x) max_x = current->x;
             if (current->y < min_y) min_y = current->y;
             if (current->y > max_y) max_y = current->y;
-            current = current->next;
+            current = v4p_nextPoint(current);
         }
         
         V4pCoord actual_width = max_x - min_x;
@@ -85,7 +85,7 @@ int main() {
             if (current->x > max_x) max_x = current->x;
             if (current->y < min_y) min_y = current->y;
             if (current->y > max_y) max_y = current->y;
-            current = current->next;
+            current = v4p_nextPoint(current);
         }
         
         V4pCoord actual_width = max_x - min_x;
@@ -131,7 +131,7 @@ int main() {
             if (current->x > max_x) max_x = current->x;
             if (current->y < min_y) min_y = current->y;
             if (current->y > max_y) max_y = current->y;
-            current = current->next;
+            current = v4p_nextPoint(current);
         }
         
         V4pCoord actual_size = max_x - min_x; // Should be square
@@ -0,0 +1,169 @@
+/**
+ * Test for batch transformations
+ * Polygons transformed by v4p_transformBatch, possibly by several threads, must end up exactly like
+ * polygons transformed one by one by v4p_transform: same points, same layers, same pixels.
+ * Jobs depending on one another (a prototype transformed along with its clones) must be done in order.
+ * Build with THREADS=1 for chunks of jobs to be transformed by several threads.
+ */
+#include "v4p.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef V4P_BACKEND_MEM
+#include "v4pi_mem.h"
+#include "check.h"
+
+#define W 160
+#define H 120
+#define SPRITES 700  // several chunks of jobs
+
+static uint8_t pixels[W * H], onePixels[W * H];
+static V4pPolygonP sprites[SPRITES];
+static V4pTransformJob jobs[SPRITES + 5];
+
+// A star with a round sub
+static V4pPolygonP newProto() {
+    V4pPolygonP p = v4p_new(V4P_ABSOLUTE, V4P_YELLOW, 0);
+    for (int i = 0; i < 10; i++) {
+        static const V4pCoord x[] = { 0, 2, 7, 3, 4, 0, -4, -3, -7, -2 };
+        static const V4pCoord y[] = { -7, -2, -2, 1, 6, 3, 6, 1, -2, -2 };
+        v4p_addPoint(p, x[i], y[i]);
+    }
+    v4p_addSub(p, v4p_newDisk(V4P_ABSOLUTE, V4P_RED, 1, 0, 0, 2));
+    return p;
+}
+
+// Add sprites: clones, instances and polygons of their own transformed in place
+static void addSprites(V4pPolygonP proto) {
+    for (int i = 0; i < SPRITES; i++) {
+        if (i % 3 == 0) {
+            sprites[i] = v4p_addClone(proto);
+        } else if (i % 3 == 1) {
+            sprites[i] = v4p_addNewInstance(proto);
+        } else {
+            sprites[i] = v4p_addNew(V4P_ABSOLUTE, 20 + i % 8, 2);
+            v4p_addCorners(sprites[i], -2, -2, 2, 2);
+        }
+    }
+}
+
+static void setJobs(int frame) {
+    for (int i = 0; i < SPRITES; i++) {
+        V4pTransformJob job = { sprites[i],         (i * 37 + frame * 3) % W, (i * 53 + frame) % H,
+                                (i / 8) * 64 % 512, i % 4,
+                                128 + (i % 5) * 64, 128 + (i % 7) * 48 };
+        jobs[i] = job;
+    }
+}
+
+// Prepend jobs depending on one another to the sprites ones: a prototype transformed in place between two
+// clones of it, a clone of the first clone, transformed before it by angle, and the first clone again
+static void setDependentJobs(int frame, V4pPolygonP moved) {
+    V4pPolygonP a = v4p_addClone(moved), b = v4p_addClone(moved), aa = v4p_addClone(a);
+    V4pTransformJob dependent[] = {
+        { a, 10 + frame, 20, 256, 1, 256, 256 },  { moved, 3, -2, 128, 0, 300, 200 },
+        { b, 50, 60 + frame, 64, 2, 256, 256 },   { aa, 30, 30, 0, 3, 200, 256 },
+        { a, 90, 40, 256 + frame, 1, 256, 384 },
+    };
+    setJobs(frame);
+    memmove(jobs + 4, jobs, sizeof(V4pTransformJob) * SPRITES);
+    memcpy(jobs, dependent, sizeof(V4pTransformJob) * 4);
+    jobs[SPRITES + 4] = dependent[4];
+}
+
+// Sum of the points of the polygons of the jobs, their subs and layers
+static uint32_t jobsSum(int n) {
+    uint32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        V4pPolygonP q = jobs[i].p;
+        for (V4pPolygonP p = q; p; p = p == q ? v4p_getFirstSub(p) : v4p_getNextSub(p)) {
+            for (V4pPointP s = v4p_getPoints(p); s; s = v4p_nextPoint(s))
+                sum = sum * 31 + s->x * 7 + s->y * 3 + s->a + s->b;
+            sum = sum * 31 + v4p_getLayer(p);
+        }
+    }
+    return sum;
+}
+
+int main() {
+    char label[96];
+    if (v4p_init()) return 1;
+
+    V4piContextP d = v4pi_newBufferContext(pixels, W, H, 0, 8);
+    v4pi_setContext(d);
+    V4pSceneP s = v4p_newScene("batch");
+    V4pContextP c = v4p_newContext(s);
+    v4p_setContext(c);
+    v4p_setBGColor(V4P_BLACK);
+    v4p_setRenderThreads(4);
+
+    V4pPolygonP proto = newProto();
+    int differ = 0, frames = 0;
+    for (int frame = 0; frame < 6; frame++, frames++) {
+        addSprites(proto);
+        setJobs(frame);
+        for (int i = 0; i < SPRITES; i++)
+            v4p_transform(sprites[i], jobs[i].dx, jobs[i].dy, jobs[i].angle, jobs[i].dz, jobs[i].zoom_x,
+                          jobs[i].zoom_y);
+        uint32_t oneSum = jobsSum(SPRITES);
+        v4p_render();
+        memcpy(onePixels, pixels, sizeof(pixels));
+        v4p_clearScene();
+
+        addSprites(proto);
+        setJobs(frame);
+        v4p_transformBatch(jobs, SPRITES);
+        v4p_render();
+        if (jobsSum(SPRITES) != oneSum || memcmp(pixels, onePixels, sizeof(pixels))) differ++;
+        v4p_clearScene();
+    }
+    snprintf(label, sizeof(label), "batch transformed like one by one (%d/%d frames differ)", differ, frames);
+    check(differ == 0, label);
+
+    differ = frames = 0;
+    for (int frame = 0; frame < 6; frame++, frames++) {
+        V4pPolygonP moved = newProto();
+        addSprites(proto);
+        setDependentJobs(frame, moved);
+        for (int i = 0; i < SPRITES + 5; i++)
+            v4p_transform(jobs[i].p, jobs[i].dx, jobs[i].dy, jobs[i].angle, jobs[i].dz, jobs[i].zoom_x,
+                          jobs[i].zoom_y);
+        uint32_t oneSum = jobsSum(SPRITES + 5);
+        v4p_render();
+        memcpy(onePixels, pixels, sizeof(pixels));
+        v4p_clearScene();
+        v4p_destroy(moved);
+
+        moved = newProto();
+        addSprites(proto);
+        setDependentJobs(frame, moved);
+        v4p_transformBatch(jobs, SPRITES + 5);
+        v4p_render();
+        if (jobsSum(SPRITES + 5) != oneSum || memcmp(pixels, onePixels, sizeof(pixels))) differ++;
+        v4p_clearScene();
+        v4p_destroy(moved);
+    }
+    snprintf(label, sizeof(label), "prototype batched with its clones transformed in order (%d/%d frames differ)",
+             differ, frames);
+    check(differ == 0, label);
+
+    v4p_destroy(proto);
+    v4p_setContext(v4p_defaultContext);
+    v4p_destroyContext(c);
+    v4p_destroyScene(s);
+    v4pi_setContext(v4pi_defaultContext);
+    v4pi_destroyContext(d);
+    v4p_quit();
+
+    printf(errors ? "Batch transform test FAILED\n" : "Batch transform test completed successfully!\n");
+    return errors ? 1 : 0;
+}
+
+#else
+
+int main() {
+    printf("Batch transform test skipped (build with BACKEND=mem)\n");
+    return 0;
+}
+
+#endif
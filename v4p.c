@@ -55,17 +55,7 @@ Concepts
 #include "v4p.h"
 #include "_v4p.h"
 
-// Comparison function for polygons based on their depth (z) field
-static int polygonDepthComparator(void* a, void* b) {
-    V4pPolygonP polyA = (V4pPolygonP)a;
-    V4pPolygonP polyB = (V4pPolygonP)b;
-
-    if (polyA->z < polyB->z) return -1;
-    if (polyA->z > polyB->z) return 1;
-    return 0;
-}
-
-V4pContextP v4p = NULL;  // current (selected) v4p Context
+V4P_TLS V4pContextP v4p = NULL;  // current (selected) v4p Context, per thread
 V4pSceneP v4p_defaultScene = NULL;
 V4pContextP v4p_defaultContext = NULL;
 
@@ -76,9 +66,51 @@ void v4p_setContext(V4pContextP p) {
 
 // Set the BG color
 V4pColor v4p_setBGColor(V4pColor bg) {
+    if (bg != v4p->background) v4p->allDirty = true;
     return (v4p->background = bg);
 }
 
+// Render only rows changed since last frame (backends built with V4PI_PARTIAL)
+int v4p_setPartialRefresh(bool enabled) {
+#ifdef V4PI_PARTIAL
+    v4p->partialRefresh = enabled;
+    v4p->allDirty = true;  // drawn rows of polygons are not known yet
+    return success;
+#else
+    v4p->partialRefresh = false;
+    return enabled ? failure : success;
+#endif
+}
+
+// Forget what the display shows (spans of drawn rows, rows drawn by polygons)
+void v4p_invalidate() {
+    v4p->allDirty = true;
+    for (int y = 0; y < v4p->drawnRowsNb; y++) v4p->drawnRows[y].spansNb = -1;
+}
+
+// Mark display rows [y0, y1) to be rendered at next frame (partial refresh)
+static void v4p_damageRows(V4pCoord y0, V4pCoord y1) {
+    if (! v4p->partialRefresh || v4p->allDirty) return;
+    y0 = IMAX(y0, 0);
+    y1 = IMIN(y1, v4p->dirtyRowsSize);
+    if (y1 > y0) v4p_memset(v4p->dirtyRows + y0, 1, y1 - y0);
+}
+
+// Mark the rows drawn by a polygon at last frame to be rendered again
+static void v4p_damage(V4pPolygonP p) {
+    v4p_damageRows(p->drawnMinY, p->drawnMaxY);
+}
+
+static void v4p_unhashActiveEdges(V4pPolygonP p);
+
+// Same for a polygon and its subs leaving the scene, their edges leaving the openable table
+static void v4p_undraw(V4pPolygonP p) {
+    v4p_damage(p);
+    p->drawnMinY = p->drawnMaxY = 0;
+    v4p_unhashActiveEdges(p);
+    for (V4pPolygonP s = p->sub1; s; s = s->next) v4p_undraw(s);
+}
+
 // Set the view
 // Uses integer scaling technique to avoid 16-bit overflow on MCUs
 // See integer_scaling.md for detailed explanation of quotient-remainder scaling
@@ -115,12 +147,14 @@ int v4p_setView(V4pCoord x0, V4pCoord y0, V4pCoord x1, V4pCoord y1) {
 // Set the display
 void v4pi_set(V4piContextP d) {
     v4p->display = d;
+    v4p->drawnDisplay = NULL;  // rows it shows are not known
     // Call to refresh internal values depending on current display
     v4p_setView(v4p->viewMinX, v4p->viewMinY, v4p->viewMaxX, v4p->viewMaxY);
 }
 
 // Set the scene
 void v4p_setScene(V4pSceneP scene) {
+    if (scene != v4p->scene) v4p->changes |= V4P_CHANGED_VIEW;  // openable table to be rebuilt
     v4p->scene = scene;
 }
 
@@ -140,7 +174,9 @@ V4pContextP v4p_newContext(V4pSceneP scene) {
     v4p->pointHeap = QuickHeapNewFor(V4pPoint);
     v4p->polygonHeap = QuickHeapNewFor(Polygon);
     v4p->activeEdgeHeap = QuickHeapNewFor(ActiveEdge);
-    v4p->openableAETable = QuickTableNew(YHASH_SIZE);  // Vertical sort
+    v4p->listHeap = QuickHeapNewFor(struct sList);
+    v4p->openableAETable = QuickTableNew(v4p_displayHeight + 1);  // Vertical sort
+    v4p->tableGeneration = 1;
     v4p->background = 0;
     v4p->viewMinX = 0;
     v4p->viewMinY = 0;
@@ -148,9 +184,30 @@ V4pContextP v4p_newContext(V4pSceneP scene) {
     v4p->viewMaxY = lineNb;
     v4p->viewWidth = lineWidth;
     v4p->viewHeight = lineNb;
-    v4p->openedPolygons = TreeNew();
-    // Set polygon comparison function (compare by z/depth)
-    TreeSetCompareFunc(polygonDepthComparator);
+    v4p->visiblePolygons = NULL;
+    v4p->rankedPolygons = NULL;
+    v4p->ranks = NULL;
+    v4p->rankedPolygonsNb = 0;
+    v4p->rankedPolygonsSize = 0;
+    v4p->instancePoints = NULL;
+    v4p->instancePointsSize = 0;
+    v4p->instancePointsOf = NULL;
+    v4p->instancePoint1 = NULL;
+    v4p->batchJobs = v4p->batchOrder = NULL;
+    v4p->batchJobsSize = 0;
+    v4p->batchGeneration = 0;
+    v4p->bands = NULL;
+    v4p->bandsNb = 0;
+    v4p->bandsSize = 0;
+    v4p->threads = 1;
+    v4p->collisionCallback = v4p_defaultContext ? v4p_defaultContext->collisionCallback : NULL;
+    v4p->partialRefresh = false;
+    v4p->allDirty = true;
+    v4p->dirtyRows = NULL;
+    v4p->dirtyRowsSize = 0;
+    v4p->drawnRows = NULL;
+    v4p->drawnRowsNb = 0;
+    v4p->drawnDisplay = NULL;
     // Initialize integer scaling factors for 1:1 mapping (no scaling)
     v4p->screenToView_wholeX = 1;
     v4p->screenToView_remX = 0;
@@ -163,16 +220,57 @@ V4pContextP v4p_newContext(V4pSceneP scene) {
     v4p->scaling = 0;
     v4p->changes = 255;  // All memoization caches to be reset
     v4p->nextId = 0;  // to number polygons uniquely
+#ifdef V4P_PACKED
+    v4p->packed1 = NULL;
+#endif
+    v4p_memset(&v4p->stats, 0, sizeof(V4pRenderStats));
 
     return v4p;
 }
 
+// Free the state of a band
+static void v4p_destroyBand(V4pBand* band) {
+    V4pOpenedEdges* e = &band->edges;
+    v4p_free(e->order);
+    v4p_free(e->merged);
+    v4p_free(e->freeSlots);
+    v4p_free(e->x);
+    v4p_free(e->h);
+    v4p_free(e->o1);
+    v4p_free(e->o2);
+    v4p_free(e->s);
+    v4p_free(e->r1);
+    v4p_free(e->r2);
+    v4p_free(e->rank);
+    v4p_free(e->arc);
+    v4p_free(e->side);
+    v4p_free(e->arcs);
+    v4p_free(e->arcUsers);
+    v4p_free(e->freeArcs);
+    QuickBitsetDestroy(band->openedPolygons);
+    v4p_free(band->spans);
+    v4p_free(band->rowEnds);
+    v4p_free(band->collisions);
+}
+
 // Delete a v4p context
 void v4p_destroyContext(V4pContextP p) {
+#ifdef V4P_PACKED
+    for (V4pPolygonP q = p->packed1; q; q = q->nextPacked) v4p_free(q->points);
+#endif
     QuickHeapDestroy(p->pointHeap);
     QuickHeapDestroy(p->polygonHeap);
     QuickHeapDestroy(p->activeEdgeHeap);
-    TreeDestroy(p->openedPolygons);
+    QuickHeapDestroy(p->listHeap);
+    for (int i = 0; i < p->bandsSize; i++) v4p_destroyBand(&p->bands[i]);
+    v4p_free(p->bands);
+    v4p_free(p->rankedPolygons);
+    v4p_free(p->ranks);
+    v4p_free(p->instancePoints);
+    v4p_free(p->batchJobs);  // batchOrder included
+    v4p_free(p->dirtyRows);
+    for (int y = 0; y < p->drawnRowsNb; y++) v4p_free(p->drawnRows[y].spans);
+    v4p_free(p->drawnRows);
     QuickTableDestroy(p->openableAETable);
     v4p_free(p);
 }
@@ -182,10 +280,12 @@ V4pSceneP v4p_newScene(const char* label) {
     V4pSceneP s = (V4pSceneP) v4p_malloc(sizeof(V4pScene));
     s->label = label ? label : "";
     s->polygons = NULL;
+    s->grid = NULL;
     return s;
 }
 
 void v4p_destroyScene(V4pSceneP s) {
+    v4p_setSceneGrid(s, 0);
     v4p_free(s);
 }
 
@@ -230,19 +330,37 @@ void v4p_quit() {
 // Create a polygon
 V4pPolygonP v4p_new(V4pProps t, V4pColor col, V4pLayer z) {
     V4pPolygonP p = QuickHeapAlloc(v4p->polygonHeap);
-    p->props = t & ~V4P_CHANGED;
+    p->props = (t & ~(V4P_CHANGED | V4P_CULLED | V4P_INSTANCE)) | V4P_TREE_CHANGED;
     p->z = z;
     p->collisionMask = 0;
     p->color = col;
     p->stroke = 0;  // 0: filled polygon
     p->point1 = NULL;
+#ifdef V4P_PACKED
+    p->points = NULL;
+    p->pointsNb = p->pointsSize = 0;
+    p->nextPacked = v4p->packed1;
+    if (p->nextPacked) p->nextPacked->prevPacked = &p->nextPacked;
+    p->prevPacked = &v4p->packed1;
+    v4p->packed1 = p;
+#endif
     p->sub1 = NULL;
     p->next = NULL;
+    p->prev = NULL;
+    p->list = NULL;
     p->parent = NULL;  // No parent by default
+    p->owner = NULL;
     p->anchor_x = 0;  // Default anchor at origin
     p->anchor_y = 0;
     p->miny = V4P_NIL;  // miny = too much => boundaries to be computed
     p->ActiveEdge1 = NULL;
+    p->hashed = 0;
+    p->batchWritten = p->batchRead = 0;
+    p->gridItem = NULL;
+    p->drawnMinY = p->drawnMaxY = 0;  // not drawn yet
+    p->instance1 = NULL;
+    p->nextInstance = NULL;
+    p->prevInstance = NULL;
     p->id = v4p->nextId++;
     return p;
 }
@@ -258,32 +376,52 @@ V4pPolygonP v4p_addNew(V4pProps t, V4pColor col, V4pLayer z) {
     return v4p_sceneAddNewPoly(v4p->scene, t, col, z);
 }
 
-// Create a disk
-V4pPolygonP v4p_newDisk(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t radius) {
+// Create an ellipse
+// Its 4 quarter arcs go by mirror pairs: each pair, and its stroke, is evaluated once per scanline.
+V4pPolygonP v4p_newEllipse(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t a,
+                           uint16_t b) {
     V4pPolygonP p = v4p_new(t, col, z);
-    if (radius == 0) {
+    if (a == 0 || b == 0) {
         return p;
     }
-    // Create disk using 4 quarter-circle arcs with center flag pattern
+    // Create ellipse using 4 quarter arcs with center flag pattern
 
     // Left-top quarter (top to left)
-    v4p_addEllipseCenter(p, center_x, center_y, radius, radius);  // Center
-    v4p_addPoint(p, center_x - radius, center_y);  // End (left)
+    v4p_addEllipseCenter(p, center_x, center_y, a, b);  // Center
+    v4p_addPoint(p, center_x - a, center_y);  // End (left)
 
     // Bottom-left quarter (left to bottom)
-    v4p_addEllipseCenter(p, center_x, center_y, radius, radius);  // Center
-    v4p_addPoint(p, center_x, center_y + radius);  // End (bottom)
+    v4p_addEllipseCenter(p, center_x, center_y, a, b);  // Center
+    v4p_addPoint(p, center_x, center_y + b);  // End (bottom)
 
     // Bottom-right quarter (bottom to right)
-    v4p_addEllipseCenter(p, center_x, center_y, radius, radius);  // Center
-    v4p_addPoint(p, center_x + radius, center_y);  // End (right)
+    v4p_addEllipseCenter(p, center_x, center_y, a, b);  // Center
+    v4p_addPoint(p, center_x + a, center_y);  // End (right)
 
     // Right-top quarter (right to top)
-    v4p_addEllipseCenter(p, center_x, center_y, radius, radius);  // Center
-    v4p_addPoint(p, center_x, center_y - radius);  // Start (top)
+    v4p_addEllipseCenter(p, center_x, center_y, a, b);  // Center
+    v4p_addPoint(p, center_x, center_y - b);  // Start (top)
+    return p;
+}
+
+// Create a disk
+V4pPolygonP v4p_newDisk(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t radius) {
+    return v4p_newEllipse(t, col, z, center_x, center_y, radius, radius);
+}
+
+// Combo EllipseNew+SceneAdd
+V4pPolygonP v4p_sceneAddNewEllipse(V4pSceneP s, V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x,
+                                   V4pCoord center_y, uint16_t a, uint16_t b) {
+    V4pPolygonP p = v4p_newEllipse(t, col, z, center_x, center_y, a, b);
+    v4p_sceneAdd(s, p);
     return p;
 }
 
+V4pPolygonP v4p_addNewEllipse(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t a,
+                              uint16_t b) {
+    return v4p_sceneAddNewEllipse(v4p->scene, t, col, z, center_x, center_y, a, b);
+}
+
 // Combo DiskNew+SceneAdd
 V4pPolygonP v4p_sceneAddNewDisk(V4pSceneP s, V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y,
                                 uint16_t radius) {
@@ -297,16 +435,60 @@ V4pPolygonP v4p_addNewDisk(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center
     return v4p_sceneAddNewDisk(v4p->scene, t, col, z, center_x, center_y, radius);
 }
 
-#define v4p_changed(P) ((P)->props |= V4P_CHANGED)
+// Have a scene level tree indexed again in its scene grid at next frame
+static void v4p_gridMoved(V4pGridItem* item) {
+    if (item->moved) return;
+    item->moved = true;
+    item->nextMoved = item->grid->moved;
+    item->grid->moved = item;
+}
+
+// Mark the subtree boxes of a polygon and its ancestors as outdated
+static void v4p_treeChanged(V4pPolygonP p) {
+    for (; p && ! (p->props & V4P_TREE_CHANGED); p = p->owner) {
+        p->props |= V4P_TREE_CHANGED;
+        if (p->gridItem) v4p_gridMoved(p->gridItem);
+    }
+}
+
+// Mark a polygon as changed, along with its instances
+void v4p_changed(V4pPolygonP p) {
+    p->props |= V4P_CHANGED;
+    v4p_treeChanged(p);
+    if (v4p->instancePointsOf == p) v4p->instancePointsOf = NULL;
+    for (V4pPolygonP i = p->instance1; i; i = i->nextInstance) {
+        i->miny = V4P_NIL;
+        v4p_changed(i);
+    }
+}
 
 V4pPolygonP v4p_destroyActiveEdges(V4pPolygonP p);
 
 // Delete a poly (including its points and subs)
 int v4p_destroy(V4pPolygonP p) {
     v4p_destroyActiveEdges(p);
+    if (v4p->instancePointsOf == p) v4p->instancePointsOf = NULL;
+    if (p->props & V4P_INSTANCE) {  // out of its prototype instances
+        *p->prevInstance = p->nextInstance;
+        if (p->nextInstance) p->nextInstance->prevInstance = p->prevInstance;
+    }
+    while (p->instance1) {  // instances left empty
+        V4pPolygonP i = p->instance1;
+        p->instance1 = i->nextInstance;
+        i->props &= ~V4P_INSTANCE;
+        i->parent = NULL;
+        i->miny = V4P_NIL;
+        v4p_changed(i);
+    }
+#ifdef V4P_PACKED
+    v4p_free(p->points);
+    *p->prevPacked = p->nextPacked;
+    if (p->nextPacked) p->nextPacked->prevPacked = p->prevPacked;
+#else
     while (p->point1) {
         v4p_destroyPointFrom(p, p->point1);
     }
+#endif
     while (p->sub1) {
         v4p_destroyFromParent(p, p->sub1);
     }
@@ -318,29 +500,24 @@ int v4p_destroy(V4pPolygonP p) {
 V4pPolygonP v4p_intoList(V4pPolygonP p, V4pPolygonP* list) {
     v4p_assert(*list != p, "List already contains the polygon");
     p->next = *list;
+    if (p->next) p->next->prev = &p->next;
+    p->prev = list;
+    p->list = list;
     *list = p;
     return p;
 }
 
 // Remove a polygon from a list linked by the next pointer
+// The polygon is unlinked through its own link in the list, whatever the list length.
 int v4p_outOfList(V4pPolygonP p, V4pPolygonP* list) {
-    V4pPolygonP ppl, pl;
-
-    if (*list == p) {
-        *list = p->next;
-    } else {
-        ppl = *list;
-        pl = ppl->next;
-        while (pl != p && pl) {
-            ppl = pl;
-            pl = pl->next;
-        }
-        if (! pl) {
-            return (v4p_error("polygon lost"), failure);
-        }
-        ppl->next = p->next;
+    if (p->list != list) {
+        return (v4p_error("polygon lost"), failure);
     }
+    *p->prev = p->next;
+    if (p->next) p->next->prev = p->prev;
     p->next = NULL;
+    p->prev = NULL;
+    p->list = NULL;
     return success;
 }
 
@@ -375,12 +552,112 @@ V4pProps v4p_disable(V4pPolygonP p) {
 // Add a polygon to an other polygon subs list
 V4pPolygonP v4p_addSub(V4pPolygonP parent, V4pPolygonP p) {
     if (parent->props & (V4P_DISABLED | V4P_IN_DISABLED)) v4p_inDisabled(p);
+    p->owner = parent;
+    v4p_treeChanged(parent);
     return v4p_intoList(p, &parent->sub1);
 }
 
+static void v4p_computeTreeLimits(V4pPolygonP p);
+
+// Bucket of a grid cell
+static inline V4pGridItem** v4p_cellBucket(V4pGrid* g, int32_t cx, int32_t cy, int level) {
+    uint32_t h = (uint32_t) cx * 73856093u ^ (uint32_t) cy * 19349663u ^ (uint32_t) level * 83492791u;
+    return &g->buckets[h & (g->bucketsNb - 1)];
+}
+
+// Level 0 grid cell column or row holding a coordinate (cells of level l: cell >> l)
+static inline int32_t v4p_cellOf(V4pGrid* g, V4pCoord c) {
+    return c >= 0 ? c / g->cellSize : -1 - (-1 - c) / g->cellSize;
+}
+
+// Unregister a tree from the grid
+static void v4p_gridErase(V4pGrid* g, V4pGridItem* item) {
+    if (! item->bucket) return;
+    *item->prev = item->next;
+    if (item->next) item->next->prev = item->prev;
+    if (item->level < V4P_GRID_LEVELS) {
+        g->itemsNb--;
+        g->levelItemsNb[item->level]--;
+    }
+    item->bucket = NULL;
+}
+
+// Register a tree in the grid cell holding its box center, at the first level whose cells
+// are as large as the box, or aside (relative tree or larger than cells of all levels)
+static void v4p_gridIndex(V4pGrid* g, V4pGridItem* item) {
+    V4pPolygonP p = item->p;
+    V4pGridItem** bucket = NULL;
+    int level = 0;
+    v4p_computeTreeLimits(p);
+    item->minx = p->treeMinX;
+    item->maxx = p->treeMaxX;
+    item->miny = p->treeMinY;
+    item->maxy = p->treeMaxY;
+    if (p->treeRelative) {
+        level = V4P_GRID_LEVELS;
+    } else if (item->minx <= item->maxx) {  // at least one point
+        int64_t size = IMAX((int64_t) item->maxx - item->minx, (int64_t) item->maxy - item->miny);
+        while (level < V4P_GRID_LEVELS && size > (int64_t) g->cellSize << level) level++;
+    }
+    if (level == V4P_GRID_LEVELS) {
+        bucket = &g->buckets[g->bucketsNb];
+    } else if (item->minx <= item->maxx) {
+        bucket = v4p_cellBucket(g, v4p_cellOf(g, item->minx + (item->maxx - item->minx) / 2) >> level,
+                                v4p_cellOf(g, item->miny + (item->maxy - item->miny) / 2) >> level, level);
+    }
+    if (bucket == item->bucket && level == item->level) return;  // moved within its cell
+
+    v4p_gridErase(g, item);
+    if (! bucket) return;
+    item->next = *bucket;
+    if (item->next) item->next->prev = &item->next;
+    item->prev = bucket;
+    *bucket = item;
+    item->bucket = bucket;
+    item->level = level;
+    if (level < V4P_GRID_LEVELS) {
+        g->itemsNb++;
+        g->levelItemsNb[level]++;
+    }
+}
+
+// Record a polygon added to a gridded scene, indexed at next frame
+static void v4p_gridAdd(V4pGrid* g, V4pPolygonP p) {
+    V4pGridItem* item = QuickHeapAlloc(g->itemHeap);
+    item->p = p;
+    item->grid = g;
+    item->bucket = NULL;
+    item->level = 0;
+    item->moved = false;
+    item->shown = -1;
+    item->order = ++g->order;
+    item->met = g->query;
+    p->gridItem = item;
+    p->props |= V4P_TREE_CHANGED;
+    v4p_gridMoved(item);
+}
+
+// Forget a polygon removed from a gridded scene
+static void v4p_gridRemove(V4pGridItem* item) {
+    V4pGrid* g = item->grid;
+    item->p->gridItem = NULL;
+    v4p_gridErase(g, item);
+    if (item->shown >= 0) {  // replaced by the last shown item
+        V4pGridItem* last = g->shown[--g->shownNb];
+        g->shown[item->shown] = last;
+        last->shown = item->shown;
+    }
+    if (item->moved) {
+        item->p = NULL;  // freed once out of the moved items
+    } else {
+        QuickHeapFree(g->itemHeap, item);
+    }
+}
+
 // Add a polygon into the scene
 V4pSceneP v4p_sceneAdd(V4pSceneP s, V4pPolygonP p) {
     v4p_intoList(p, &(s->polygons));
+    if (s->grid) v4p_gridAdd(s->grid, p);
     return v4p->scene;
 }
 
@@ -390,7 +667,9 @@ V4pPolygonP v4p_add(V4pPolygonP p) {
 
 // Remove a polygon from the scene
 V4pSceneP v4p_sceneRemove(V4pSceneP s, V4pPolygonP p) {
-    v4p_outOfList(p, &(s->polygons));
+    if (v4p_outOfList(p, &(s->polygons))) return s;
+    v4p_undraw(p);
+    if (p->gridItem) v4p_gridRemove(p->gridItem);
     return s;
 }
 
@@ -420,7 +699,10 @@ V4pPolygonP v4p_addNewSub(V4pPolygonP parent, V4pProps t, V4pColor col, V4pLayer
 
 // remove a poly from an other poly subs list, then delete it
 int v4p_destroyFromParent(V4pPolygonP parent, V4pPolygonP p) {
-    return v4p_outOfList(p, &parent->sub1) || v4p_destroy(p);
+    if (v4p_outOfList(p, &parent->sub1)) return failure;
+    v4p_undraw(p);
+    v4p_treeChanged(parent);
+    return v4p_destroy(p);
 }
 
 // Get the first sub-polygon of a parent
@@ -461,9 +743,39 @@ V4pProps v4p_setRelative(V4pPolygonP p, bool relative) {
     }
 }
 
+#ifdef V4P_PACKED
+// Make room for n points in the points array of a polygon
+static int v4p_growPoints(V4pPolygonP p, int n) {
+    if (n < p->pointsSize) return success;
+    int size = n * 2 + 4;
+    V4pPoint* points = v4p_realloc(p->points, sizeof(V4pPoint) * size);
+    if (! points) return (v4p_error("v4p_growPoints failed, cannot allocate %d points\n", size), failure);
+    points[0].x = points[0].y = V4P_NIL;  // list head
+    points[0].a = 0;
+    points[0].b = V4P_POINTS_HEAD;
+    p->points = points;
+    p->pointsSize = size;
+    p->point1 = p->pointsNb ? &points[p->pointsNb] : NULL;
+    return success;
+}
+#endif
+
+// Add a new first point to the points list of a polygon
+static V4pPointP v4p_pushPoint(V4pPolygonP p) {
+#ifdef V4P_PACKED
+    if (v4p_growPoints(p, p->pointsNb + 1)) return NULL;
+    return p->point1 = &p->points[++p->pointsNb];
+#else
+    V4pPointP s = QuickHeapAlloc(v4p->pointHeap);
+    s->next = p->point1;
+    return p->point1 = s;
+#endif
+}
+
 // Add a polygon point
 V4pPointP v4p_addEllipseCenter(V4pPolygonP p, V4pCoord x, V4pCoord y, V4pCoord a, V4pCoord b) {
-    V4pPointP s = QuickHeapAlloc(v4p->pointHeap);
+    V4pPointP s = v4p_pushPoint(p);
+    if (! s) return NULL;
     s->x = x;
     s->y = y;
     s->a = a;
@@ -489,8 +801,6 @@ V4pPointP v4p_addEllipseCenter(V4pPolygonP p, V4pCoord x, V4pCoord y, V4pCoord a
             }
         }
     }
-    s->next = p->point1;
-    p->point1 = s;
     v4p_changed(p);
     return s;
 }
@@ -499,29 +809,19 @@ V4pPointP v4p_addPoint(V4pPolygonP p, V4pCoord x, V4pCoord y) {
     return v4p_addEllipseCenter(p, x, y, 0, 0);
 }
 
-// Create a new point
-V4pPointP v4p_newPoint(V4pCoord x, V4pCoord y, V4pCoord a, V4pCoord b) {
-    V4pPointP point = QuickHeapAlloc(v4p->pointHeap);
-    point->x = x;
-    point->y = y;
-    point->a = a;
-    point->b = b;
-    point->next = NULL;
-    return point;
-}
-
-// Destroy a point
-void v4p_destroyPoint(V4pPointP point) {
-    QuickHeapFree(v4p->pointHeap, point);
+// Add a Bezier control point, bending the edge between its neighbor points
+V4pPointP v4p_addControlPoint(V4pPolygonP p, V4pCoord x, V4pCoord y) {
+    return v4p_addEllipseCenter(p, x, y, 0, V4P_CONTROL_POINT);
 }
 
 // Add a "jump" point into a polygon
 V4pPointP v4p_addJump(V4pPolygonP p) {
-    V4pPointP s = QuickHeapAlloc(v4p->pointHeap);
+    V4pPointP s = v4p_pushPoint(p);
+    if (! s) return NULL;
     s->x = V4P_NIL;
     s->y = V4P_NIL;
-    s->next = p->point1;
-    p->point1 = s;
+    s->a = 0;
+    s->b = 0;
     v4p_changed(p);
     return s;
 }
@@ -535,13 +835,15 @@ uint32_t v4p_setStroke(V4pPolygonP p, uint32_t stroke) {
 
 // set polygon color
 V4pColor v4p_setColor(V4pPolygonP p, V4pColor c) {
-    // Not changed because not affecting geometry
+    // Not changed because not affecting geometry, but drawn rows are
+    if (c != p->color) v4p_damage(p);
     return p->color = c;
 }
 
 // set polygon layer (z-depth)
 V4pLayer v4p_setLayer(V4pPolygonP p, V4pLayer z) {
-    // Not changed because not affecting geometry
+    // Not changed because not affecting geometry, but drawn rows are
+    if (z != p->z) v4p_damage(p);
     return p->z = z;  // Full uint32_t depth support
 }
 
@@ -570,6 +872,11 @@ V4pPointP v4p_getPoints(V4pPolygonP p) {
     return p->point1;
 }
 
+// returns the point following a point in its list, NULL at the end
+V4pPointP v4p_nextPoint(V4pPointP s) {
+    return V4P_NEXT_POINT(s);
+}
+
 // returns a polygon depth (layer index)
 V4pLayer v4p_getLayer(V4pPolygonP p) {
     return p->z;
@@ -612,6 +919,16 @@ V4pPointP v4p_movePoint(V4pPolygonP p, V4pPointP s, V4pCoord x, V4pCoord y) {
 
 // remove a point from a polygon
 V4pPolygonP v4p_destroyPointFrom(V4pPolygonP p, V4pPointP s) {
+#ifdef V4P_PACKED
+    int i = s - p->points;
+    if (i < 1 || i > p->pointsNb) return NULL;
+    if (p->miny != V4P_NIL && (s->x == p->minx || s->y == p->miny || s->x == p->maxx || s->y == p->maxy)) {
+        p->miny = V4P_NIL;  // boundaries to be computed again
+    }
+    for (; i < p->pointsNb; i++) p->points[i] = p->points[i + 1];
+    p->pointsNb--;
+    p->point1 = p->pointsNb ? &p->points[p->pointsNb] : NULL;
+#else
     V4pPointP pps, ps;
 
     if (p->point1 == s)
@@ -632,6 +949,7 @@ V4pPolygonP v4p_destroyPointFrom(V4pPolygonP p, V4pPointP s) {
     }
 
     QuickHeapFree(v4p->pointHeap, s);
+#endif
 
     v4p_changed(p);
     return p;
@@ -649,7 +967,9 @@ ActiveEdgeP v4p_addNewArcActiveEdge(V4pPolygonP p, V4pPointP a, V4pPointP center
     ae->p = p;
     ae->isStroke = isStroke;
     ae->isArc = true;
-    ListPrepend(p->ActiveEdge1, ae);
+    ae->isBezier = false;
+    ListPrependIn(v4p->listHeap, p->ActiveEdge1, ae);
+    v4p_count(v4p->stats, edgesBuilt, 1);
 
     int ax, ay, bx, by;
     if (a->y <= b->y) {
@@ -675,6 +995,18 @@ ActiveEdgeP v4p_addNewArcActiveEdge(V4pPolygonP p, V4pPointP a, V4pPointP center
     ae->as.arc.ra = center->a;
     ae->as.arc.rb = center->b;
 
+    // Lead a former arc edge of the same ellipse and rows, among the last ones
+    ae->lead = ae->host = ae->rider = NULL;
+    List l = ListNext(p->ActiveEdge1);
+    for (int n = 0; l && n < 8; l = ListNext(l), n++) {
+        ActiveEdgeP twin = (ActiveEdgeP) ListData(l);
+        if (twin->isArc && ! twin->lead && twin->ay == ay && twin->by == by && twin->as.arc.cx == center->x
+            && twin->as.arc.cy == center->y && twin->as.arc.ra == center->a && twin->as.arc.rb == center->b) {
+            twin->lead = ae;
+            break;
+        }
+    }
+
     if (p->props & V4P_RELATIVE) {  // Relative polygon
         ae->avx = ax;
         ae->avy = ay;
@@ -697,8 +1029,10 @@ ActiveEdgeP v4p_addNewActiveEdge(V4pPolygonP p, V4pPointP a, V4pPointP b, bool i
     ActiveEdgeP ae = QuickHeapAlloc(v4p->activeEdgeHeap);
     ae->p = p;
     ae->isStroke = isStroke;
-    ae->isArc = false;
-    ListPrepend(p->ActiveEdge1, ae);
+    ae->isArc = ae->isBezier = false;
+    ae->lead = ae->host = ae->rider = NULL;
+    ListPrependIn(v4p->listHeap, p->ActiveEdge1, ae);
+    v4p_count(v4p->stats, edgesBuilt, 1);
 
     int ax, ay, bx, by;
     if (a->y <= b->y) {
@@ -728,54 +1062,133 @@ ActiveEdgeP v4p_addNewActiveEdge(V4pPolygonP p, V4pPointP a, V4pPointP b, bool i
     return ae;
 }
 
+// Create a Bezier ActiveEdge of a polygon, from its points c[0, degree], monotonic in y
+ActiveEdgeP v4p_addNewBezierActiveEdge(V4pPolygonP p, const V4pPoint* c, int degree, bool isStroke) {
+    ActiveEdgeP ae = QuickHeapAlloc(v4p->activeEdgeHeap);
+    ae->p = p;
+    ae->isStroke = isStroke;
+    ae->isArc = false;
+    ae->isBezier = true;
+    ae->lead = ae->host = ae->rider = NULL;
+    ListPrependIn(v4p->listHeap, p->ActiveEdge1, ae);
+    v4p_count(v4p->stats, edgesBuilt, 1);
+
+    bool down = c[0].y <= c[degree].y;  // top to bottom
+    const V4pPoint *a = &c[down ? 0 : degree], *b = &c[down ? degree : 0];
+    const V4pPoint *c1 = &c[down ? 1 : degree - 1], *c2 = &c[down ? degree - 1 : 1];
+    ae->ax = a->x;
+    ae->ay = a->y;
+    ae->bx = b->x;
+    ae->by = b->y;
+    ae->as.bezier.c1x = c1->x;
+    ae->as.bezier.c1y = c1->y;
+    ae->as.bezier.c2x = c2->x;
+    ae->as.bezier.c2y = c2->y;
+    ae->as.bezier.degree = (int8_t) degree;
+
+    if (p->props & V4P_RELATIVE) {  // Relative polygon
+        ae->avx = ae->ax;
+        ae->avy = ae->ay;
+        ae->bvx = ae->bx;
+        ae->bvy = ae->by;
+        ae->as.bezier.c1vx = c1->x;
+        ae->as.bezier.c1vy = c1->y;
+        ae->as.bezier.c2vx = c2->x;
+        ae->as.bezier.c2vy = c2->y;
+    }
+
+    v4p_trace(EDGE, "Bezier edge %p (%d,%d)-(%d,%d)\n", (void*) ae, ae->ax, ae->ay, ae->bx, ae->by);
+    return ae;
+}
+
+// Are the ActiveEdges of a polygon in the current openable table
+#define v4p_isHashed(P) ((P)->hashed == v4p->tableGeneration)
+
+// Openable table entry of ActiveEdges starting above the view (after the display rows)
+#define V4P_ABOVE_VIEW ((V4pCoord) v4p->openableAETable->sizeOfTable - 1)
+
+// Drop the ActiveEdges of a polygon from the openable table
+static void v4p_unhashActiveEdges(V4pPolygonP p) {
+    if (! v4p_isHashed(p)) return;
+    for (List l = p->ActiveEdge1; l; l = ListNext(l)) {
+        V4pCoord bucket = ((ActiveEdgeP) ListData(l))->bucket;
+        if (bucket != V4P_UNHASHED) QuickTableRemove(v4p->openableAETable, bucket, l);
+    }
+    p->hashed = 0;
+}
+
 // delete all ActiveEdges of a poly
 V4pPolygonP v4p_destroyActiveEdges(V4pPolygonP p) {
     List l;
     ActiveEdgeP b;
+    v4p_unhashActiveEdges(p);
     l = p->ActiveEdge1;
     while (l) {
         b = (ActiveEdgeP) ListData(l);
         QuickHeapFree(v4p->activeEdgeHeap, b);
-        l = ListFree(l);
+        l = ListFreeIn(v4p->listHeap, l);
     }
     p->ActiveEdge1 = NULL;
     return p;
 }
 
-// Called by v4p_transformClone to recursively transform a clone polygon and its subs from the parent polygon
-// angle is in range [0, 512) where 512 = 360 degrees, so angle step is 360/512 degrees
-V4pPolygonP v4p_recPolygonTransformClone(bool estSub, V4pPolygonP p, V4pPolygonP c, V4pCoord dx, V4pCoord dy,
-                                         int angle, V4pLayer dz, V4pCoord anchor_x, V4pCoord anchor_y, V4pCoord zoom_x,
-                                         V4pCoord zoom_y) {
-    V4pPointP sp, sc;
-    V4pCoord x, y, x2, y2, tx, ty;
-
+// Transform the points of a polygon into the matching points of its clone (see v4p_transformClone)
+// The clone list is as long as the polygon one once prepared (see v4p_prepareClone), and may be the same list.
+static void v4p_transformPoints(const V4pTransform* t, const QuickRotation* rotation, V4pPointP sp, V4pPointP sc) {
     // Pre-compute integer scaling factors for zoom using quotient-remainder technique
     // This avoids 16-bit overflow on MCUs by breaking scaling into safe components
     // See integer_scaling.md for detailed explanation
-    V4pCoord zoomX_whole = zoom_x / 256;
-    V4pCoord zoomX_rem = zoom_x % 256;
-    V4pCoord zoomY_whole = zoom_y / 256;
-    V4pCoord zoomY_rem = zoom_y % 256;
+    V4pCoord zoomX_whole = t->zoom_x / 256;
+    V4pCoord zoomX_rem = t->zoom_x % 256;
+    V4pCoord zoomY_whole = t->zoom_y / 256;
+    V4pCoord zoomY_rem = t->zoom_y % 256;
+
+    for (; sp && sc; sp = V4P_NEXT_POINT(sp), sc = V4P_NEXT_POINT(sc)) {
+        V4pCoord x = sp->x, y = sp->y, x2, y2;
+        if (x == V4P_NIL || y == V4P_NIL) {
+            sc->x = V4P_NIL;
+            sc->y = V4P_NIL;
+            sc->a = 0;
+            sc->b = 0;
+            continue;
+        }
 
+        // Translate point relative to anchor, then apply rotation
+        straightenWith(rotation, x - t->anchor_x, y - t->anchor_y, &x2, &y2);
+
+        // Apply zoom/scaling using integer scaling technique
+        // This prevents 16-bit overflow by using quotient-remainder decomposition
+        // Formula: x2 * zoom_x / 256 = x2 * zoomX_whole + ((x2 * zoomX_rem) + SIGN(x2) * (256 / 2)) / 256
+        x2 = x2 * zoomX_whole + (x2 * zoomX_rem + SIGN(x2) * 128) / 256;
+        y2 = y2 * zoomY_whole + (y2 * zoomY_rem + SIGN(y2) * 128) / 256;
+
+        // Translate back and apply position delta
+        sc->x = x2 + t->anchor_x + t->dx;
+        sc->y = y2 + t->anchor_y + t->dy;
+        sc->a = sp->a == 0 ? 0 : sp->a * zoomX_whole + (sp->a * zoomX_rem + 128) / 256;
+        sc->b = sp->a == 0 ? sp->b : sp->b * zoomY_whole + (sp->b * zoomY_rem + 128) / 256;  // control flag kept
+    }
+}
+
+// Give a clone as many points as its parent polygon, shift its z and mark it changed, before its points
+// get transformed
+static int v4p_prepareClone(V4pPolygonP p, V4pPolygonP c, V4pLayer dz) {
     c->z = p->z + dz;  // Shift z
     c->miny = V4P_NIL;  // Invalidate computed boundaries
+    v4p_changed(c);
 
-    sp = p->point1;
-    sc = c->point1;
+#ifdef V4P_PACKED
+    if (v4p_growPoints(c, p->pointsNb)) return failure;
+    c->pointsNb = p->pointsNb;
+    c->point1 = c->pointsNb ? &c->points[c->pointsNb] : NULL;
+#else
+    V4pPointP sp = p->point1, sc = c->point1;
     V4pPointP prev_sc = NULL;  // To track previous point for adding new points
 
-    // Pre-compute lwmCosa and lwmSina for the given angle to optimize rotation of all points
-    computeCosSin(angle);
-
-    while (sp) {
+    for (; sp; sp = sp->next) {
         // Create sc point if it doesn't exist (clone has fewer points than parent)
         if (!sc) {
             V4pPointP new_point = QuickHeapAlloc(v4p->pointHeap);
-            new_point->x = V4P_NIL;
-            new_point->y = V4P_NIL;
-            new_point->a = 0;
-            new_point->b = 0,
             new_point->next = NULL;
 
             if (prev_sc) {
@@ -785,37 +1198,7 @@ V4pPolygonP v4p_recPolygonTransformClone(bool estSub, V4pPolygonP p, V4pPolygonP
             }
             sc = new_point;
         }
-
-        x = sp->x;
-        y = sp->y;
-        if (x != V4P_NIL && y != V4P_NIL) {
-            // Translate point relative to anchor
-            tx = x - anchor_x;
-            ty = y - anchor_y;
-
-            // Apply rotation
-            straighten(tx, ty, &x2, &y2);
-
-            // Apply zoom/scaling using integer scaling technique
-            // This prevents 16-bit overflow by using quotient-remainder decomposition
-            // Formula: x2 * zoom_x / 256 = x2 * zoomX_whole + ((x2 * zoomX_rem) + SIGN(x2) * (256 / 2)) / 256
-            x2 = x2 * zoomX_whole + (x2 * zoomX_rem + SIGN(x2) * 128) / 256;
-            y2 = y2 * zoomY_whole + (y2 * zoomY_rem + SIGN(y2) * 128) / 256;
-
-            // Translate back and apply position delta
-            sc->x = x2 + anchor_x + dx;
-            sc->y = y2 + anchor_y + dy;
-            sc->a = sp->a == 0 ? 0 : sp->a * zoomX_whole + (sp->a * zoomX_rem + 128) / 256;
-            sc->b = sp->b == 0 ? 0 : sp->b * zoomY_whole + (sp->b * zoomY_rem + 128) / 256;
-        } else {
-            sc->x = V4P_NIL;
-            sc->y = V4P_NIL;
-            sc->a = 0;
-            sc->b = 0;
-        }
-
         prev_sc = sc;
-        sp = sp->next;
         sc = sc->next;
     }
 
@@ -826,10 +1209,27 @@ V4pPolygonP v4p_recPolygonTransformClone(bool estSub, V4pPolygonP p, V4pPolygonP
         sc = sc->next;
         if (prev_sc) {
             prev_sc->next = sc;
+        } else {
+            c->point1 = sc;
         }
         QuickHeapFree(v4p->pointHeap, to_free);
     }
-    v4p_changed(c);
+#endif
+    return success;
+}
+
+// Called by v4p_transformClone to recursively transform a clone polygon and its subs from the parent polygon
+// angle is in range [0, 512) where 512 = 360 degrees, so angle step is 360/512 degrees
+V4pPolygonP v4p_recPolygonTransformClone(bool estSub, V4pPolygonP p, V4pPolygonP c, V4pCoord dx, V4pCoord dy,
+                                         int angle, V4pLayer dz, V4pCoord anchor_x, V4pCoord anchor_y, V4pCoord zoom_x,
+                                         V4pCoord zoom_y) {
+    V4pTransform t = { dx, dy, anchor_x, anchor_y, zoom_x, zoom_y, angle };
+
+    // Pre-compute cos and sin of the given angle to optimize rotation of all points
+    QuickRotation rotation;
+    computeRotation(&rotation, angle);
+
+    if (! v4p_prepareClone(p, c, dz)) v4p_transformPoints(&t, &rotation, p->point1, c->point1);
     if (estSub && p->next) {
         v4p_recPolygonTransformClone(true, p->next, c->next, dx, dy, angle, dz, anchor_x, anchor_y, zoom_x, zoom_y);
     }
@@ -839,8 +1239,22 @@ V4pPolygonP v4p_recPolygonTransformClone(bool estSub, V4pPolygonP p, V4pPolygonP
     return c;
 }
 
+// Called by v4p_transformClone to recursively set the transform of an instance and its subs
+static V4pPolygonP v4p_recInstanceTransform(bool estSub, V4pPolygonP c, const V4pTransform* t, V4pLayer dz) {
+    if (c->props & V4P_INSTANCE) {
+        c->transform = *t;
+        c->z = c->parent->z + dz;  // Shift z
+        c->miny = V4P_NIL;  // Invalidate computed boundaries
+        v4p_changed(c);
+    }
+    if (estSub && c->next) v4p_recInstanceTransform(true, c->next, t, dz);
+    if (c->sub1) v4p_recInstanceTransform(true, c->sub1, t, dz);
+    return c;
+}
+
 // Transform a clone c of a polygon p so that points(c) =
 // transfo(points(p),delta-x/y, turn-angle)
+// An instance c merely stores the transform, its points being transformed when its edges are built.
 V4pPolygonP v4p_transformClone(V4pPolygonP p, V4pPolygonP c, V4pCoord dx, V4pCoord dy, int angle, V4pLayer dz,
                                V4pCoord zoom_x, V4pCoord zoom_y) {
     /* a voir: ratiox et ratioy :
@@ -850,6 +1264,10 @@ V4pPolygonP v4p_transformClone(V4pPolygonP p, V4pPolygonP c, V4pCoord dx, V4pCoo
     // Use the clone's anchor point for the entire transformation tree
     V4pCoord anchor_x = c->anchor_x;
     V4pCoord anchor_y = c->anchor_y;
+    if (c->props & V4P_INSTANCE) {
+        V4pTransform t = { dx, dy, anchor_x, anchor_y, zoom_x, zoom_y, angle };
+        return v4p_recInstanceTransform(false, c, &t, dz);
+    }
     return v4p_recPolygonTransformClone(false, p, c, dx, dy, angle, dz, anchor_x, anchor_y, zoom_x, zoom_y);
 }
 
@@ -865,6 +1283,235 @@ V4pPolygonP v4p_transform(V4pPolygonP p, V4pCoord dx, V4pCoord dy, int angle, V4
     }
 }
 
+// Called by v4p_transformBatch to prepare a clone polygon and its subs, see v4p_recPolygonTransformClone
+static void v4p_recPrepareClone(bool estSub, V4pPolygonP p, V4pPolygonP c, V4pLayer dz) {
+    v4p_prepareClone(p, c, dz);
+    if (estSub && p->next) v4p_recPrepareClone(true, p->next, c->next, dz);
+    if (p->sub1) v4p_recPrepareClone(true, p->sub1, c->sub1, dz);
+}
+
+// Points of batch jobs gathered into arrays, transformed by loops over the arrays then scattered back
+// Gathered points share a rotation, each job having a segment of the arrays for its zoom and translation.
+// The rotation loop runs over a multiple of V4P_TRANSFORM_LANES points, for compilers to vectorize it whole.
+#define V4P_TRANSFORM_SCRATCH 256
+#define V4P_TRANSFORM_LANES 8
+
+typedef struct {
+    int end;  // End of the segment points
+    V4pCoord zoomX, zoomY, remX, remY;  // Zoom / 256, zoom % 256
+    V4pCoord dx, dy;  // Anchor plus position delta
+} V4pTransformSegment;
+
+typedef struct {
+    QuickRotation rotation;
+    int n;  // Gathered points
+    V4pCoord x[V4P_TRANSFORM_SCRATCH], y[V4P_TRANSFORM_SCRATCH];  // Relative to the anchor, then transformed
+    V4pPointP from[V4P_TRANSFORM_SCRATCH], to[V4P_TRANSFORM_SCRATCH];  // Polygon point, clone point to write
+    int segmentsNb;
+    V4pTransformSegment segments[V4P_TRANSFORM_SCRATCH];
+    int nilNb;
+    V4pPointP nil[V4P_TRANSFORM_SCRATCH];  // Clone points of V4P_NIL points
+} V4pTransformScratch;
+
+// Start the segment of the points gathered for a job
+static void v4p_scratchSegment(V4pTransformScratch* s, const V4pTransform* t) {
+    V4pTransformSegment* g = &s->segments[s->segmentsNb++];
+    g->end = s->n;
+    g->zoomX = t->zoom_x / 256;
+    g->zoomY = t->zoom_y / 256;
+    g->remX = t->zoom_x % 256;
+    g->remY = t->zoom_y % 256;
+    g->dx = t->anchor_x + t->dx;
+    g->dy = t->anchor_y + t->dy;
+}
+
+// Transform then scatter the gathered points, as done point by point by v4p_transformPoints
+static void v4p_flushScratch(V4pTransformScratch* s) {
+    int n = s->n, lanes = (n + V4P_TRANSFORM_LANES - 1) & ~(V4P_TRANSFORM_LANES - 1);
+    V4pCoord *x = s->x, *y = s->y;
+
+    if (s->rotation.angle) {
+        int cosa = s->rotation.cosa, sina = s->rotation.sina;
+        for (int i = n; i < lanes; i++) x[i] = y[i] = 0;  // Padding points
+        for (int i = 0; i < lanes; i++) {
+            V4pCoord x1 = x[i], y1 = y[i];
+            x[i] = (x1 * cosa - y1 * sina) >> 8;
+            y[i] = (x1 * sina + y1 * cosa) >> 8;
+        }
+    }
+
+    // Zoom with the quotient-remainder technique of v4p_transformPoints, translate and scatter, job by job
+    for (int k = 0, i = 0; k < s->segmentsNb; k++) {
+        const V4pTransformSegment* g = &s->segments[k];
+        for (; i < g->end; i++) {
+            V4pPointP sp = s->from[i], sc = s->to[i];
+            V4pCoord x2 = x[i], y2 = y[i];
+            uint16_t a = sp->a, b = sp->b;
+            sc->x = x2 * g->zoomX + (x2 * g->remX + SIGN(x2) * 128) / 256 + g->dx;
+            sc->y = y2 * g->zoomY + (y2 * g->remY + SIGN(y2) * 128) / 256 + g->dy;
+            sc->a = a == 0 ? 0 : a * g->zoomX + (a * g->remX + 128) / 256;
+            sc->b = a == 0 ? b : b * g->zoomY + (b * g->remY + 128) / 256;  // control flag kept
+        }
+    }
+    for (int i = 0; i < s->nilNb; i++) {
+        V4pPointP sc = s->nil[i];
+        sc->x = V4P_NIL;
+        sc->y = V4P_NIL;
+        sc->a = 0;
+        sc->b = 0;
+    }
+    s->n = s->nilNb = s->segmentsNb = 0;
+}
+
+// Gather the points of a prepared clone polygon and its subs, as transformed by v4p_recPolygonTransformClone
+static void v4p_recGatherPoints(bool estSub, V4pPolygonP p, V4pPolygonP c, V4pTransformScratch* s,
+                                const V4pTransform* t) {
+    V4pCoord ax = t->anchor_x, ay = t->anchor_y;
+    int i = s->n;  // Kept out of s, written along with the arrays
+    for (V4pPointP sp = p->point1, sc = c->point1; sp && sc; sp = V4P_NEXT_POINT(sp), sc = V4P_NEXT_POINT(sc)) {
+        V4pCoord x = sp->x, y = sp->y;
+        if (i == V4P_TRANSFORM_SCRATCH || s->nilNb == V4P_TRANSFORM_SCRATCH) {
+            s->segments[s->segmentsNb - 1].end = s->n = i;
+            v4p_flushScratch(s);
+            v4p_scratchSegment(s, t);
+            i = 0;
+        }
+        if (x == V4P_NIL || y == V4P_NIL) {
+            s->nil[s->nilNb++] = sc;
+            continue;
+        }
+        s->x[i] = x - ax;
+        s->y[i] = y - ay;
+        s->from[i] = sp;
+        s->to[i++] = sc;
+    }
+    s->segments[s->segmentsNb - 1].end = s->n = i;
+    if (estSub && p->next) v4p_recGatherPoints(true, p->next, c->next, s, t);
+    if (p->sub1) v4p_recGatherPoints(true, p->sub1, c->sub1, s, t);
+}
+
+// Transform the points of clones, jobs being taken by angle (see v4p_takeBatchRun), their point lists being
+// prepared beforehand or along
+static void v4p_transformOrderedJobs(const V4pTransformJob* jobs, const int* order, int n, bool prepared) {
+    V4pTransformScratch s;
+    int angle = 0;
+    computeRotation(&s.rotation, angle);
+    s.n = s.nilNb = s.segmentsNb = 0;
+    for (int i = 0; i < n; i++) {
+        const V4pTransformJob* job = &jobs[order[i]];
+        V4pPolygonP c = job->p, p = c->parent ? c->parent : c;
+        int jobAngle = (uint16_t) job->angle & 0x1FF;
+        if (jobAngle != angle || s.segmentsNb == V4P_TRANSFORM_SCRATCH) {  // Gathered points are rotated alike
+            v4p_flushScratch(&s);
+            angle = jobAngle;
+            computeRotation(&s.rotation, angle);
+        }
+        V4pTransform t = { job->dx, job->dy, c->anchor_x, c->anchor_y, job->zoom_x, job->zoom_y, job->angle };
+        if (! prepared) v4p_recPrepareClone(false, p, c, job->dz);
+        v4p_scratchSegment(&s, &t);
+        v4p_recGatherPoints(false, p, c, &s, &t);
+    }
+    v4p_flushScratch(&s);
+}
+
+// Stamp a clone polygon and its subs as written by the batch run, returning whether the run already
+// reads or writes one of them
+static bool v4p_recStampWritten(bool estSub, V4pPolygonP c) {
+    bool met = c->batchWritten == v4p->batchGeneration || c->batchRead == v4p->batchGeneration;
+    c->batchWritten = v4p->batchGeneration;
+    if (estSub && c->next) met |= v4p_recStampWritten(true, c->next);
+    if (c->sub1) met |= v4p_recStampWritten(true, c->sub1);
+    return met;
+}
+
+// Stamp a polygon and its subs as read by the batch run, returning whether the run already writes one of them
+static bool v4p_recStampRead(bool estSub, V4pPolygonP p) {
+    bool met = p->batchWritten == v4p->batchGeneration;
+    p->batchRead = v4p->batchGeneration;
+    if (estSub && p->next) met |= v4p_recStampRead(true, p->next);
+    if (p->sub1) met |= v4p_recStampRead(true, p->sub1);
+    return met;
+}
+
+// Take a run of jobs of a batch, from the first one to the first one depending on the run: a polygon
+// written twice, or read by a job and written by another (a prototype transformed along with its clones).
+// Instances get their transform, and clone jobs are listed into v4p->batchJobs then by angle into v4p->batchOrder.
+// Returns the end of the run.
+static int v4p_takeBatchRun(const V4pTransformJob* jobs, int start, int n, int* clones) {
+    int first[512 + 1] = { 0 };
+    int end, m = 0;
+    v4p->batchGeneration++;
+    for (end = start; end < n; end++) {
+        const V4pTransformJob* job = &jobs[end];
+        V4pPolygonP c = job->p;
+        if (c->props & V4P_INSTANCE) {
+            V4pTransform t = { job->dx, job->dy, c->anchor_x, c->anchor_y, job->zoom_x, job->zoom_y, job->angle };
+            v4p_recInstanceTransform(false, c, &t, job->dz);
+            continue;
+        }
+        V4pPolygonP p = c->parent ? c->parent : c;
+        if (v4p_recStampWritten(false, c) || (p != c && v4p_recStampRead(false, p))) {
+            if (end > start) break;  // Run to be transformed before this job
+        }
+        v4p->batchJobs[m++] = end;
+        first[((uint16_t) job->angle & 0x1FF) + 1]++;
+    }
+    for (int angle = 0; angle < 512; angle++) first[angle + 1] += first[angle];
+    for (int i = 0; i < m; i++) {
+        int job = v4p->batchJobs[i];
+        v4p->batchOrder[first[(uint16_t) jobs[job].angle & 0x1FF]++] = job;
+    }
+    *clones = m;
+    return end;
+}
+
+// Jobs of a batch transformed by a task (see v4p_transformBatch)
+#define V4P_TRANSFORM_CHUNK 256
+
+typedef struct {
+    const V4pTransformJob* jobs;
+    const int* order;
+    int n;
+} V4pTransformBatch;
+
+// called by v4p_parallelFor(), possibly from a worker thread: only points of the chunk polygons are written
+static void v4p_transformChunkTask(void* arg, int chunk) {
+    const V4pTransformBatch* batch = (const V4pTransformBatch*) arg;
+    int start = chunk * V4P_TRANSFORM_CHUNK;
+    v4p_transformOrderedJobs(batch->jobs, batch->order + start, IMIN(batch->n - start, V4P_TRANSFORM_CHUNK), true);
+}
+
+// Transform many polygons at once, each job being done as by v4p_transform
+// Jobs are split into runs of jobs independent from one another (see v4p_takeBatchRun), points of the jobs of a
+// run sharing an angle being transformed together. When the current context renders with several threads (see
+// v4p_setRenderThreads), point lists of a run are prepared first, then chunks of jobs are transformed in parallel.
+int v4p_transformBatch(const V4pTransformJob* jobs, int n) {
+    // Runs of a chunk per thread at most, their polygons being met again while cached
+    int run = IMIN(n, V4P_TRANSFORM_CHUNK * v4p->threads);
+    if (run > v4p->batchJobsSize) {
+        int* batchJobs = v4p_realloc(v4p->batchJobs, sizeof(int) * run * 2);
+        if (! batchJobs) return (v4p_error("v4p_transformBatch failed, cannot allocate %d jobs\n", run), failure);
+        v4p->batchJobs = batchJobs;
+        v4p->batchOrder = batchJobs + run;
+        v4p->batchJobsSize = run;
+    }
+    for (int start = 0, clones; start < n;) {
+        start = v4p_takeBatchRun(jobs, start, IMIN(n, start + run), &clones);
+        int chunks = (clones + V4P_TRANSFORM_CHUNK - 1) / V4P_TRANSFORM_CHUNK;
+        if (v4p->threads <= 1 || chunks <= 1) {
+            v4p_transformOrderedJobs(jobs, v4p->batchOrder, clones, false);
+        } else {
+            for (int i = 0; i < clones; i++) {
+                const V4pTransformJob* job = &jobs[v4p->batchJobs[i]];
+                v4p_recPrepareClone(false, job->p->parent ? job->p->parent : job->p, job->p, job->dz);
+            }
+            V4pTransformBatch batch = { jobs, v4p->batchOrder, clones };
+            v4p_parallelFor(chunks, v4p_transformChunkTask, &batch, v4p->threads);
+        }
+    }
+    return success;
+}
+
 // Center a polygon by computing its bounds and transforming it to (0,0)
 V4pPolygonP v4p_centerPolygon(V4pPolygonP p) {
     V4pCoord minx, maxx, miny, maxy;
@@ -888,7 +1535,7 @@ V4pPolygonP v4p_recPolygonClone(bool estSub, V4pPolygonP p) {
     V4pPointP s;
     V4pPolygonP c = v4p_new(p->props, p->color, p->z);
     c->stroke = p->stroke;  // Copy stroke property
-    for (s = p->point1; s; s = s->next) v4p_addEllipseCenter(c, s->x, s->y, s->a, s->b);
+    for (s = p->point1; s; s = V4P_NEXT_POINT(s)) v4p_addEllipseCenter(c, s->x, s->y, s->a, s->b);
 
     // Set parent reference for clones (but not for sub-polygons)
     if (! estSub) {
@@ -898,14 +1545,26 @@ V4pPolygonP v4p_recPolygonClone(bool estSub, V4pPolygonP p) {
         c->anchor_y = p->anchor_y;
     }
 
-    if (estSub && p->next) c->next = v4p_recPolygonClone(true, p->next);
-    if (p->sub1) c->sub1 = v4p_recPolygonClone(true, p->sub1);
+    if (estSub && p->next) {
+        c->next = v4p_recPolygonClone(true, p->next);
+        c->next->prev = &c->next;
+    }
+    if (p->sub1) {
+        c->sub1 = v4p_recPolygonClone(true, p->sub1);
+        c->sub1->prev = &c->sub1;
+    }
+    for (V4pPolygonP sub = c->sub1; sub; sub = sub->next) {
+        sub->owner = c;
+        sub->list = &c->sub1;
+    }
 
     return c;
 }
 
 // clone a polygon (including its descendants) with parent reference
+// The clone of an instance is another instance of the same prototype.
 V4pPolygonP v4p_clone(V4pPolygonP p) {
+    if (p->props & V4P_INSTANCE) return v4p_newInstance(p);
     return v4p_recPolygonClone(false, p);
 }
 
@@ -920,6 +1579,84 @@ V4pPolygonP v4p_addClone(V4pPolygonP p) {
     return v4p_sceneAddClone(v4p->scene, p);
 }
 
+static V4pPolygonP v4p_recNewInstance(V4pPolygonP proto, const V4pTransform* t, V4pLayer dz);
+
+// Add instances of a subs list to an instance, in the subs list order (last ones being added first)
+static void v4p_addSubInstances(V4pPolygonP i, V4pPolygonP sub, const V4pTransform* t, V4pLayer dz) {
+    if (! sub) return;
+    v4p_addSubInstances(i, sub->next, t, dz);
+    v4p_addSub(i, v4p_recNewInstance(sub, t, dz));
+}
+
+// called by v4p_newInstance
+static V4pPolygonP v4p_recNewInstance(V4pPolygonP proto, const V4pTransform* t, V4pLayer dz) {
+    V4pPolygonP i = v4p_new(proto->props, proto->color, proto->z + dz);
+    i->props |= V4P_INSTANCE;
+    i->stroke = proto->stroke;
+    i->parent = proto;
+    i->anchor_x = proto->anchor_x;
+    i->anchor_y = proto->anchor_y;
+    i->transform = *t;
+    i->nextInstance = proto->instance1;  // into the prototype instances
+    if (proto->instance1) proto->instance1->prevInstance = &i->nextInstance;
+    proto->instance1 = i;
+    i->prevInstance = &proto->instance1;
+    v4p_addSubInstances(i, proto->sub1, t, dz);
+    v4p_changed(i);
+    return i;
+}
+
+// Create an instance of a polygon (including its descendants)
+// An instance of an instance shares its prototype and transform.
+V4pPolygonP v4p_newInstance(V4pPolygonP proto) {
+    if (proto->props & V4P_INSTANCE)
+        return v4p_recNewInstance(proto->parent, &proto->transform, proto->z - proto->parent->z);
+    V4pTransform t = { 0, 0, proto->anchor_x, proto->anchor_y, 256, 256, 0 };  // at the prototype place
+    return v4p_recNewInstance(proto, &t, 0);
+}
+
+// combo newInstance+SceneAdd
+V4pPolygonP v4p_sceneAddNewInstance(V4pSceneP s, V4pPolygonP proto) {
+    V4pPolygonP i = v4p_newInstance(proto);
+    v4p_sceneAdd(s, i);
+    return i;
+}
+
+V4pPolygonP v4p_addNewInstance(V4pPolygonP proto) {
+    return v4p_sceneAddNewInstance(v4p->scene, proto);
+}
+
+// Points of a polygon, those of an instance being its prototype points transformed into a buffer
+// reused by the next instance (limits then edges of a changed instance are computed from one transform)
+static V4pPointP v4p_pointsOf(V4pPolygonP p) {
+    if (! (p->props & V4P_INSTANCE)) return p->point1;
+    if (v4p->instancePointsOf == p) return v4p->instancePoint1;
+    V4pPointP s;
+    int n = 0;
+    for (s = p->parent->point1; s; s = V4P_NEXT_POINT(s)) n++;
+    if (n >= v4p->instancePointsSize) {
+        V4pPoint* points = v4p_realloc(v4p->instancePoints, sizeof(V4pPoint) * (n + 1) * 2);
+        if (! points) return (v4p_error("v4p_pointsOf failed, cannot allocate %d points\n", (n + 1) * 2), NULL);
+        v4p->instancePoints = points;
+        v4p->instancePointsSize = (n + 1) * 2;
+    }
+    V4pPoint* buffer = v4p->instancePoints;
+#ifdef V4P_PACKED
+    buffer[0].x = buffer[0].y = V4P_NIL;  // list head
+    buffer[0].a = 0;
+    buffer[0].b = V4P_POINTS_HEAD;
+    v4p->instancePoint1 = n ? &buffer[n] : NULL;
+#else
+    for (int i = 0; i < n; i++) buffer[i].next = i + 1 < n ? &buffer[i + 1] : NULL;
+    v4p->instancePoint1 = n ? buffer : NULL;
+#endif
+    QuickRotation rotation;
+    computeRotation(&rotation, p->transform.angle);
+    v4p_transformPoints(&p->transform, &rotation, p->parent->point1, v4p->instancePoint1);
+    v4p->instancePointsOf = p;
+    return v4p->instancePoint1;
+}
+
 // set polygon anchor point to its center
 V4pPolygonP v4p_setAnchorToCenter(V4pPolygonP p) {
     if (p->miny == V4P_NIL) {
@@ -940,16 +1677,16 @@ V4pPolygonP v4p_setAnchor(V4pPolygonP p, V4pCoord x, V4pCoord y) {
 // compute the minimal rectangle surrounding a polygon
 V4pPolygonP v4p_computeLimits(V4pPolygonP p) {
     V4pCoord minx = V4P_NIL, maxx = V4P_NIL, miny = V4P_NIL, maxy = V4P_NIL;
-    V4pPointP s = p->point1;
+    V4pPointP s = v4p_pointsOf(p);
     while (s && (s->x == V4P_NIL || s->y == V4P_NIL || V4P_IS_ARC_CENTER(s))) {
-        s = s->next;
+        s = V4P_NEXT_POINT(s);
     }
     if (s) {  // at least one point
         minx = s->x;
         maxx = s->x;
         miny = s->y;
         maxy = s->y;
-        for (s = s->next; s; s = s->next) {
+        for (s = V4P_NEXT_POINT(s); s; s = V4P_NEXT_POINT(s)) {
             V4pCoord x = s->x, y = s->y;
             if (x == V4P_NIL || y == V4P_NIL || V4P_IS_ARC_CENTER(s)) continue;
 
@@ -994,7 +1731,7 @@ void v4p_absoluteToView(V4pCoord x, V4pCoord y, V4pCoord* xa, V4pCoord* ya) {
 
 // return false if polygon is located out of the view area
 bool v4p_isVisible(V4pPolygonP p) {
-    if (! p->point1) return false;
+    if (! ((p->props & V4P_INSTANCE) ? p->parent->point1 : p->point1)) return false;
     if (p->miny == V4P_NIL)  // unknown limits
         v4p_computeLimits(p);
 
@@ -1004,8 +1741,6 @@ bool v4p_isVisible(V4pPolygonP p) {
         v4p_absoluteToView(minx, miny, &minx, &miny);
         v4p_absoluteToView(maxx, maxy, &maxx, &maxy);
     }
-    p->minyv = miny;
-    p->maxyv = maxy;
     return (maxx >= 0 && maxy >= 0 && minx < v4p_displayWidth && miny < v4p_displayHeight);
 }
 
@@ -1074,6 +1809,90 @@ void v4p_addArcEdges(V4pPolygonP p, V4pPoint* sa, V4pPoint* center, V4pPoint* sb
     v4p_addNewArcActiveEdge(p, &cur, center, sb, isStroke);
 }
 
+// Bezier curve parameters t in [0, 1] are fixed point numbers, in 1/65536 units
+#define V4P_BEZIER_ONE ((int64_t) 1 << 16)
+
+// Point of the blossom of a Bezier curve (de Casteljau algorithm, with a parameter per level)
+// The curve piece along [u, v] is bent by the blossoms at (u, u, u), (u, u, v), (u, v, v) and (v, v, v).
+static V4pPoint v4p_bezierBlossom(const V4pPoint* c, int degree, const int64_t* t) {
+    int64_t x[4], y[4];  // in 1/256 units
+    for (int i = 0; i <= degree; i++) {
+        x[i] = (int64_t) c[i].x * 256;
+        y[i] = (int64_t) c[i].y * 256;
+    }
+    for (int l = 0; l < degree; l++) {
+        for (int i = 0; i < degree - l; i++) {
+            x[i] += (x[i + 1] - x[i]) * t[l] / V4P_BEZIER_ONE;
+            y[i] += (y[i + 1] - y[i]) * t[l] / V4P_BEZIER_ONE;
+        }
+    }
+    V4pPoint pt = c[0];
+    pt.x = (V4pCoord) ((x[0] + SIGN(x[0]) * 128) / 256);
+    pt.y = (V4pCoord) ((y[0] + SIGN(y[0]) * 128) / 256);
+    return pt;
+}
+
+// Parameters in (0, 1) where a Bezier curve turns up or down, in order, returns their count
+static int v4p_bezierTurns(const V4pPoint* c, int degree, int64_t* turns) {
+    // y'(t) has the sign of the Bernstein polynomial of the control steps d0, d1 (and d2)
+    const int64_t one = V4P_BEZIER_ONE;
+    int64_t d0 = (int64_t) c[1].y - c[0].y, d1 = (int64_t) c[2].y - c[1].y;
+    int64_t d2 = degree == 3 ? (int64_t) c[3].y - c[2].y : 0;
+    // Steps scaled down below 2²⁹ for their products with t² to fit in 64 bits, keeping the sign of y'(t)
+    while (IMAX(IABS(d0), IMAX(IABS(d1), IABS(d2))) >= ((int64_t) 1 << 29)) {
+        d0 /= 2;
+        d1 /= 2;
+        d2 /= 2;
+    }
+    if (degree == 2) {  // d0·(1 - t) + d1·t
+        if (SIGN(d0) * SIGN(d1) >= 0) return 0;
+        turns[0] = d0 * one / (d0 - d1);
+        return 1;
+    }
+    // d0·(1 - t)² + 2·d1·t·(1 - t) + d2·t², monotonic on each side of its extremum: bisected there
+#define V4P_BEZIER_SLOPE(T) SIGN((d0 * (one - (T)) + d1 * (T)) * (one - (T)) + (d1 * (one - (T)) + d2 * (T)) * (T))
+    int64_t bounds[3] = { 0, one, one }, den = d0 - 2 * d1 + d2;
+    int boundsNb = 2, n = 0;
+    if (den && (d0 - d1) * SIGN(den) > 0 && (d0 - d1) * SIGN(den) < IABS(den)) {
+        bounds[1] = (d0 - d1) * one / den;
+        boundsNb = 3;
+    }
+    for (int i = 0; i + 1 < boundsNb; i++) {
+        int64_t lo = bounds[i], hi = bounds[i + 1];
+        int slo = V4P_BEZIER_SLOPE(lo);
+        if (slo * V4P_BEZIER_SLOPE(hi) >= 0) continue;
+        while (hi - lo > 1) {
+            int64_t mid = (lo + hi) / 2;
+            if (V4P_BEZIER_SLOPE(mid) == slo) lo = mid; else hi = mid;
+        }
+        turns[n++] = hi;
+    }
+#undef V4P_BEZIER_SLOPE
+    return n;
+}
+
+// Add the ActiveEdges of a Bezier curve from sa to sb, bent by 1 or 2 control points
+// The curve is split where it turns up or down, into pieces along which rows are met once.
+void v4p_addBezierEdges(V4pPolygonP p, V4pPoint* sa, V4pPointP* controls, int controlsNb, V4pPoint* sb,
+                        bool isStroke) {
+    V4pPoint c[4], piece[4];
+    int64_t turns[3], t[3], u = 0;
+    int degree = controlsNb + 1;
+
+    c[0] = *sa;
+    for (int i = 0; i < controlsNb; i++) c[i + 1] = *controls[i];
+    c[degree] = *sb;
+    int n = v4p_bezierTurns(c, degree, turns);
+    turns[n++] = V4P_BEZIER_ONE;
+    for (int i = 0; i < n; u = turns[i++]) {
+        for (int j = 0; j <= degree; j++) {
+            for (int l = 0; l < degree; l++) t[l] = l < degree - j ? u : turns[i];
+            piece[j] = v4p_bezierBlossom(c, degree, t);
+        }
+        if (piece[0].y != piece[degree].y) v4p_addNewBezierActiveEdge(p, piece, degree, isStroke);  // not flat
+    }
+}
+
 // build a list of ActiveEdges for a given polygon
 V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
     bool isVisible = false;
@@ -1116,6 +1935,8 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
 
     // Need to recompile AE
     // ====================
+    v4p_damage(p);  // rows drawn with former edges
+    p->drawnMinY = p->drawnMaxY = 0;
     v4p_destroyActiveEdges(p);
 
     if ((p->props & (V4P_DISABLED | V4P_IN_DISABLED | V4P_HIDDEN))) return p;
@@ -1125,15 +1946,17 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
         return p;
     }
 
-    V4pPointP s1 = p->point1;
+    V4pPointP s1 = v4p_pointsOf(p);
     v4p_trace(POLYGON, "Building active edges for polygon %p\n", (void*) p);
     while (s1) {  // path subset
         if (s1->x == V4P_NIL || s1->y == V4P_NIL) {
-            s1 = s1->next;
+            s1 = V4P_NEXT_POINT(s1);
             continue;
         }
-        V4pPointP sa = s1, sb = sa->next;
+        V4pPointP sa = s1, sb = V4P_NEXT_POINT(sa);
         V4pPointP center = NULL;
+        V4pPointP controls[2];  // Bezier control points met since sa
+        int controlsNb = 0;
         v4p_trace(POLYGON, "Path with first point (%d, %d)\n", sa->x, sa->y);
 
         // sub-path loop
@@ -1143,9 +1966,14 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
                 // This is an arc: [sa, center, sb]
                 center = sb;
                 v4p_trace(POLYGON, "Processing arc center (%d, %d)\n", center->x, center->y);
-                sb = center->next;
+                sb = V4P_NEXT_POINT(center);
                 continue;  // sa doesn't change; loop to handle adjacent centers (illegal)
             }
+            if (V4P_IS_CONTROL_POINT(sb)) {
+                if (controlsNb < 2) controls[controlsNb++] = sb;  // more are ignored
+                sb = V4P_NEXT_POINT(sb);
+                continue;
+            }
 
             v4p_trace(POLYGON, "Processing edge from (%d, %d) to (%d, %d)\n", sa->x, sa->y, sb->x, sb->y);
 
@@ -1157,6 +1985,12 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
                     v4p_addArcEdges(p, sa, center, sb, true);
                 }
                 center = NULL;
+            } else if (controlsNb) {  // add Bezier edges
+                v4p_addBezierEdges(p, sa, controls, controlsNb, sb, false);
+                if (p->stroke) {
+                    v4p_addBezierEdges(p, sa, controls, controlsNb, sb, true);
+                }
+                controlsNb = 0;
             } else if (sa->y != sb->y) {  // add an active edge
                 v4p_addNewActiveEdge(p, sa, sb, false);
                 if (p->stroke) { // if stroke we add another "is_stroke" active edge
@@ -1180,7 +2014,7 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
 
             // next edge
             sa = sb;
-            sb = sb->next;
+            sb = V4P_NEXT_POINT(sb);
         }
         if (! sb) {  // no more vertice
             v4p_trace(POLYGON, "End of path subset, last point (%d, %d)\n", sa->x, sa->y);
@@ -1193,6 +2027,12 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
                         v4p_addNewArcActiveEdge(p, sa, center, s1, true);
                     }
                     center = NULL;
+                } else if (controlsNb) {
+                    v4p_addBezierEdges(p, sa, controls, controlsNb, s1, false);
+                    if (p->stroke) {
+                        v4p_addBezierEdges(p, sa, controls, controlsNb, s1, true);
+                    }
+                    controlsNb = 0;
                 } else if (sa->y != s1->y) {
                     v4p_trace(POLYGON, "Adding closing edge from (%d,%d) to (%d,%d)\n",
                               sa->x, sa->y, s1->x, s1->y);
@@ -1214,7 +2054,7 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
             }
             break;
         }
-        s1 = sb->next;
+        s1 = V4P_NEXT_POINT(sb);
     }  // path subset
 
     v4p_trace(POLYGON, "Finished building active edges for polygon %p\n", (void*) p);
@@ -1222,350 +2062,1167 @@ V4pPolygonP v4p_buildActiveEdgeList(V4pPolygonP p) {
     return p;
 }
 
-// called by v4p_sortActiveEdge()
-int compareActiveEdgeX(void* data1, void* data2) {
-    ActiveEdgeP ae1 = data1, ae2 = data2;
-    return (ae1->x < ae2->x);
+// Do two arc edges follow a same ellipse in view along the same rows, at the same x offsets from its center
+static bool v4p_isArcTwin(ActiveEdgeP a, ActiveEdgeP b) {
+    return a->avy == b->avy && a->bvy == b->bvy && a->as.arc.cvx == b->as.arc.cvx && a->as.arc.cvy == b->as.arc.cvy
+           && a->as.arc.a == b->as.arc.a && a->as.arc.b == b->as.arc.b
+           && IABS(a->avx - a->as.arc.cvx) == IABS(b->avx - b->as.arc.cvx)
+           && IABS(a->bvx - a->as.arc.cvx) == IABS(b->bvx - b->as.arc.cvx);
+}
+
+// Put an ActiveEdge into the openable table, at its top row in view
+static void v4p_hashActiveEdge(List l, ActiveEdgeP ae, bool isRelative) {
+    if (! isRelative) {
+        v4p_absoluteToView(ae->ax, ae->ay, &(ae->avx), &(ae->avy));
+        v4p_absoluteToView(ae->bx, ae->by, &(ae->bvx), &(ae->bvy));
+        if (ae->isArc) {
+            v4p_absoluteToView(ae->as.arc.cx, ae->as.arc.cy, &(ae->as.arc.cvx), &(ae->as.arc.cvy));
+            if (! v4p->scaling) {
+                ae->as.arc.a = ae->as.arc.ra;
+                ae->as.arc.b = ae->as.arc.rb;
+            } else {
+                // one can't use v4p_absoluteToView for radius (they are not translated)
+                ae->as.arc.a = ae->as.arc.ra * v4p->screenToView_wholeX
+                    + ((ae->as.arc.ra * v4p->screenToView_remX) + SIGN(ae->as.arc.ra) * (v4p->viewWidth / 2))
+                        / v4p->viewWidth;
+                ae->as.arc.b = ae->as.arc.rb * v4p->screenToView_wholeY
+                    + ((ae->as.arc.rb * v4p->screenToView_remY) + SIGN(ae->as.arc.rb) * (v4p->viewHeight / 2))
+                        / v4p->viewHeight;
+            }
+            ae->as.arc.a2 = ae->as.arc.a * ae->as.arc.a;
+            ae->as.arc.b2 = ae->as.arc.b * ae->as.arc.b;
+        } else if (ae->isBezier) {
+            v4p_absoluteToView(ae->as.bezier.c1x, ae->as.bezier.c1y, &(ae->as.bezier.c1vx), &(ae->as.bezier.c1vy));
+            v4p_absoluteToView(ae->as.bezier.c2x, ae->as.bezier.c2y, &(ae->as.bezier.c2vx), &(ae->as.bezier.c2vy));
+        }
+    }
+    if (ae->isArc) {  // opened along with its lead (hashed before) when both start alike in view
+        ActiveEdgeP host = ae->lead && ae->lead->host ? ae->lead->host : ae->lead;
+        ae->host = ae->rider = NULL;
+        if (host && v4p_isArcTwin(host, ae)) {
+            ae->host = host;
+            ae->rider = host->rider;
+            host->rider = ae;
+            ae->bucket = V4P_UNHASHED;
+            return;
+        }
+    }
+    if (ae->bvy <= 0 || ae->avy >= V4P_ABOVE_VIEW) {  // out of the display rows
+        ae->bucket = V4P_UNHASHED;
+        return;
+    }
+    ae->bucket = ae->avy < 0 ? V4P_ABOVE_VIEW : ae->avy;
+    QuickTableAdd(v4p->openableAETable, ae->bucket, l);
+}
+
+// Compute again the bounding box of a polygon and its subs once outdated
+static void v4p_computeTreeLimits(V4pPolygonP p) {
+    if (! (p->props & V4P_TREE_CHANGED)) return;
+    if (p->miny == V4P_NIL) v4p_computeLimits(p);
+
+    V4pCoord minx = V4P_NIL, maxx = -V4P_NIL, miny = V4P_NIL, maxy = -V4P_NIL;  // empty
+    bool relative = p->props & V4P_RELATIVE;
+    if (p->miny != V4P_NIL) {  // at least one point
+        minx = p->minx;
+        maxx = p->maxx;
+        miny = p->miny;
+        maxy = p->maxy;
+    }
+    for (V4pPolygonP s = p->sub1; s; s = s->next) {
+        v4p_computeTreeLimits(s);
+        relative |= s->treeRelative;
+        minx = IMIN(minx, s->treeMinX);
+        maxx = IMAX(maxx, s->treeMaxX);
+        miny = IMIN(miny, s->treeMinY);
+        maxy = IMAX(maxy, s->treeMaxY);
+    }
+    p->treeMinX = minx;
+    p->treeMaxX = maxx;
+    p->treeMinY = miny;
+    p->treeMaxY = maxy;
+    p->treeRelative = relative;
+    p->props &= ~V4P_TREE_CHANGED;
+}
+
+// return false if a polygon and its subs are located out of the view area
+static bool v4p_isTreeVisible(V4pPolygonP p) {
+    if (p->treeRelative) return true;  // not in scene coordinates
+    if (p->treeMinX > p->treeMaxX) return false;  // no point at all
+
+    V4pCoord minx, maxx, miny, maxy;
+    v4p_absoluteToView(p->treeMinX, p->treeMinY, &minx, &miny);
+    v4p_absoluteToView(p->treeMaxX, p->treeMaxY, &maxx, &maxy);
+    return (maxx >= 0 && maxy >= 0 && minx < v4p_displayWidth && miny < v4p_displayHeight);
 }
 
-// sort an ActiveEdge list ordered by 'x'
-List v4p_sortActiveEdge(List list) {
-    ListSetCompareFunc(compareActiveEdgeX);
-    return ListSort(list);
+// Free the ActiveEdges of a polygon and its subs out of the view
+static void v4p_cull(V4pPolygonP p) {
+    v4p_damage(p);  // rows drawn with former edges
+    p->drawnMinY = p->drawnMaxY = 0;
+    v4p_destroyActiveEdges(p);
+    for (V4pPolygonP s = p->sub1; s; s = s->next) v4p_cull(s);
 }
 
-// build AE lists
-void v4p_buildOpenableAELists(V4pPolygonP polygonChain) {
-    V4pPolygonP p;
+// Have the ActiveEdges of a polygon and its subs built again, back in view
+static void v4p_uncull(V4pPolygonP p) {
+    p->props = (p->props & ~V4P_CULLED) | V4P_CHANGED;
+    for (V4pPolygonP s = p->sub1; s; s = s->next) v4p_uncull(s);
+}
+
+// build AE lists of a polygon and its subs
+// Subtrees out of the view are skipped at once, their edges being freed.
+// The openable table is kept across frames: only edges of changed or added polygons are
+// converted to view and hashed, unless the view changed and all of them are.
+static void v4p_buildTreeAELists(V4pPolygonP p) {
     List l;
     ActiveEdgeP ae;
+    int isRelative = p->props & V4P_RELATIVE;
+
+    if (p->sub1) {
+        v4p_computeTreeLimits(p);
+        if (! v4p_isTreeVisible(p)) {
+            if (! (p->props & V4P_CULLED)) {
+                v4p_cull(p);
+                p->props |= V4P_CULLED;
+            }
+            return;
+        }
+        if (p->props & V4P_CULLED) v4p_uncull(p);
+    }
 
-    for (p = polygonChain; p; p = p->next) {
-        int isRelative = p->props & V4P_RELATIVE;
+    v4p_buildActiveEdgeList(p);
 
-        v4p_buildActiveEdgeList(p);
+    if (p->ActiveEdge1) {  // to be ranked by depth
+        ListPrependIn(v4p->listHeap, v4p->visiblePolygons, p);
+        v4p->rankedPolygonsNb++;
+    }
 
-        l = p->ActiveEdge1;
-        while (l) {
+    if (! v4p_isHashed(p)) {
+        V4pCoord minyv = V4P_NIL, maxyv = -V4P_NIL;
+        for (l = p->ActiveEdge1; l; l = ListNext(l)) {
             ae = (ActiveEdgeP) ListData(l);
-            if (isRelative) {
-                QuickTableAdd(v4p->openableAETable, (ae->ay > 0 ? ae->ay : 0) & YHASH_MASK, l);
-            } else {
-                v4p_absoluteToView(ae->ax, ae->ay, &(ae->avx), &(ae->avy));
-                v4p_absoluteToView(ae->bx, ae->by, &(ae->bvx), &(ae->bvy));
-                if (ae->isArc) {
-                    v4p_absoluteToView(ae->as.arc.cx, ae->as.arc.cy, &(ae->as.arc.cvx), &(ae->as.arc.cvy));
-                    v4p_absoluteToView(ae->as.arc.ra, ae->as.arc.rb, &(ae->as.arc.a), &(ae->as.arc.b));
-                    if (v4p->scaling) {
-                        // one can't use v4p_absoluteToView for radius (they are not translated)
-                        ae->as.arc.a = ae->as.arc.ra * v4p->screenToView_wholeX
-                            + ((ae->as.arc.ra * v4p->screenToView_remX) + SIGN(ae->as.arc.ra) * (v4p->viewWidth / 2))
-                                / v4p->viewWidth;
-                        ae->as.arc.b = ae->as.arc.rb * v4p->screenToView_wholeY
-                            + ((ae->as.arc.rb * v4p->screenToView_remY) + SIGN(ae->as.arc.rb) * (v4p->viewHeight / 2))
-                                / v4p->viewHeight;
-                    }
-                    ae->as.arc.a2 = ae->as.arc.a * ae->as.arc.a;
-                    ae->as.arc.b2 = ae->as.arc.b * ae->as.arc.b;
-                }
+            v4p_hashActiveEdge(l, ae, isRelative);
+            minyv = IMIN(minyv, ae->avy);
+            maxyv = IMAX(maxyv, ae->bvy);
+        }
+        p->minyv = minyv;
+        p->maxyv = maxyv;
+        p->hashed = v4p->tableGeneration;
+    }
 
-                if (ae->ay < v4p->viewMinY) {
-                    QuickTableAdd(v4p->openableAETable, 0, l);
-                } else {
-                    QuickTableAdd(v4p->openableAETable, ae->avy & YHASH_MASK, l);
-                }
-            }
-            l = ListNext(l);
+    // Rows drawn by the polygon, to render again once it changes (partial refresh)
+    if (v4p->partialRefresh && (v4p->allDirty || p->drawnMinY == p->drawnMaxY)) {
+        p->drawnMinY = IMAX(p->minyv, 0);
+        p->drawnMaxY = IMIN(p->maxyv, v4p_displayHeight);
+        if (p->drawnMinY >= p->drawnMaxY) p->drawnMinY = p->drawnMaxY = 0;
+        v4p_damage(p);
+    }
+
+    for (V4pPolygonP s = p->sub1; s; s = s->next) v4p_buildTreeAELists(s);
+}
+
+// build AE lists of a polygon chain
+void v4p_buildOpenableAELists(V4pPolygonP polygonChain) {
+    for (V4pPolygonP p = polygonChain; p; p = p->next) v4p_buildTreeAELists(p);
+}
+
+// Meet a grid item once per query
+static void v4p_gridMeet(V4pGrid* g, V4pGridItem* item, List* met, int* metNb) {
+    if (item->met == g->query) return;
+    item->met = g->query;
+    ListPrependIn(v4p->listHeap, *met, item);
+    (*metNb)++;
+}
+
+// Meet the items of a bucket whose tree box overlaps [x0, x1] x [y0, y1]
+static void v4p_gridMeetBucket(V4pGrid* g, V4pGridItem* item, V4pCoord x0, V4pCoord y0, V4pCoord x1, V4pCoord y1,
+                               List* met, int* metNb) {
+    for (; item; item = item->next) {
+        if (item->minx <= x1 && item->maxx >= x0 && item->miny <= y1 && item->maxy >= y0)
+            v4p_gridMeet(g, item, met, metNb);
+    }
+}
+
+// called by v4p_buildGridAELists()
+static int compareGridOrder(void* data1, void* data2) {
+    return ((V4pGridItem*) data1)->order > ((V4pGridItem*) data2)->order;
+}
+
+// Register again all trees of a gridded scene in more buckets, once crowded
+static void v4p_gridRehash(V4pSceneP s) {
+    V4pGrid* g = s->grid;
+    int bucketsNb = g->bucketsNb;
+    while (g->itemsNb > 2 * bucketsNb) bucketsNb *= 2;
+    V4pGridItem** buckets = (V4pGridItem**) v4p_malloc(sizeof(V4pGridItem*) * (bucketsNb + 1));
+    if (! buckets) return;  // kept crowded
+    v4p_memset(buckets, 0, sizeof(V4pGridItem*) * (bucketsNb + 1));
+
+    v4p_free(g->buckets);
+    g->buckets = buckets;
+    g->bucketsNb = bucketsNb;
+    g->itemsNb = 0;
+    v4p_memset(g->levelItemsNb, 0, sizeof(g->levelItemsNb));
+    for (V4pPolygonP p = s->polygons; p; p = p->next) {
+        p->gridItem->bucket = NULL;
+        v4p_gridIndex(g, p->gridItem);
+    }
+}
+
+// build AE lists of the polygons of a gridded scene
+// Trees changed since last frame are indexed again first. Then are met, in scene order, trees
+// registered in cells overlapping the view, held aside, or shown at last frame (to free their edges).
+static int v4p_buildGridAELists(V4pSceneP s) {
+    V4pGrid* g = s->grid;
+    V4pGridItem* item;
+    List l, met = NULL;
+    int metNb = 0, i;
+
+    while ((item = g->moved)) {
+        g->moved = item->nextMoved;
+        item->moved = false;
+        if (! item->p) {  // removed from the scene meanwhile
+            QuickHeapFree(g->itemHeap, item);
+            continue;
+        }
+        v4p_gridIndex(g, item);
+    }
+    if (g->itemsNb > 2 * g->bucketsNb) v4p_gridRehash(s);
+
+    // View box, with a margin for coordinates rounded to display pixels
+    V4pCoord x0 = v4p->viewMinX - v4p->viewWidth / v4p_displayWidth - 1;
+    V4pCoord x1 = v4p->viewMaxX + v4p->viewWidth / v4p_displayWidth + 1;
+    V4pCoord y0 = v4p->viewMinY - v4p->viewHeight / v4p_displayHeight - 1;
+    V4pCoord y1 = v4p->viewMaxY + v4p->viewHeight / v4p_displayHeight + 1;
+
+    g->query++;
+    for (i = 0; i < g->shownNb; i++) v4p_gridMeet(g, g->shown[i], &met, &metNb);
+    for (item = g->buckets[g->bucketsNb]; item; item = item->next) v4p_gridMeet(g, item, &met, &metNb);
+    for (int level = 0; level < V4P_GRID_LEVELS; level++) {
+        if (! g->levelItemsNb[level]) continue;
+        // Cells holding the center of trees overlapping the view box
+        V4pCoord m = (V4pCoord) (((int64_t) g->cellSize << level) + 1) / 2;
+        int32_t cx0 = v4p_cellOf(g, x0 - m) >> level, cx1 = v4p_cellOf(g, x1 + m) >> level;
+        int32_t cy0 = v4p_cellOf(g, y0 - m) >> level, cy1 = v4p_cellOf(g, y1 + m) >> level;
+        if ((int64_t) (cx1 - cx0 + 1) * (cy1 - cy0 + 1) > g->bucketsNb) {  // scanning each bucket once is cheaper
+            for (i = 0; i < g->bucketsNb; i++) v4p_gridMeetBucket(g, g->buckets[i], x0, y0, x1, y1, &met, &metNb);
+            break;
         }
+        for (int32_t cy = cy0; cy <= cy1; cy++) {
+            for (int32_t cx = cx0; cx <= cx1; cx++)
+                v4p_gridMeetBucket(g, *v4p_cellBucket(g, cx, cy, level), x0, y0, x1, y1, &met, &metNb);
+        }
+    }
 
-        if (p->sub1) {
-            v4p_buildOpenableAELists(p->sub1);
+    if (metNb > g->shownSize) {
+        V4pGridItem** shown = v4p_realloc(g->shown, sizeof(V4pGridItem*) * metNb * 2);
+        if (! shown) {
+            for (l = met; l; l = ListFreeIn(v4p->listHeap, l))
+                ;
+            return (v4p_error("v4p_buildGridAELists failed, cannot allocate %d items\n", metNb * 2), failure);
         }
+        g->shown = shown;
+        g->shownSize = metNb * 2;
+    }
+    for (i = 0; i < g->shownNb; i++) g->shown[i]->shown = -1;
+    g->shownNb = 0;
+
+    for (l = ListSort(met, compareGridOrder); l; l = ListFreeIn(v4p->listHeap, l)) {
+        item = ListData(l);
+        v4p_buildTreeAELists(item->p);
+        if (v4p_isTreeVisible(item->p)) {
+            item->shown = g->shownNb;
+            g->shown[g->shownNb++] = item;
+        }
+    }
+    return success;
+}
+
+// Index the scene polygons in a grid, or drop the grid
+int v4p_setSceneGrid(V4pSceneP s, V4pCoord cellSize) {
+    V4pGrid* g = s->grid;
+    V4pPolygonP p;
+    uint32_t order = 0;
+
+    if (g) {
+        for (p = s->polygons; p; p = p->next) p->gridItem = NULL;
+        QuickHeapDestroy(g->itemHeap);
+        v4p_free(g->buckets);
+        v4p_free(g->shown);
+        v4p_free(g);
+        s->grid = NULL;
+    }
+    if (cellSize <= 0) return success;
+
+    g = (V4pGrid*) v4p_malloc(sizeof(V4pGrid));
+    if (! g) return (v4p_error("v4p_setSceneGrid failed, cannot allocate grid\n"), failure);
+    g->cellSize = cellSize;
+    g->bucketsNb = 256;
+    g->buckets = (V4pGridItem**) v4p_malloc(sizeof(V4pGridItem*) * (g->bucketsNb + 1));
+    if (! g->buckets) {
+        v4p_free(g);
+        return (v4p_error("v4p_setSceneGrid failed, cannot allocate grid\n"), failure);
     }
+    v4p_memset(g->buckets, 0, sizeof(V4pGridItem*) * (g->bucketsNb + 1));
+    g->itemsNb = 0;
+    v4p_memset(g->levelItemsNb, 0, sizeof(g->levelItemsNb));
+    g->itemHeap = QuickHeapNewFor(V4pGridItem);
+    g->moved = NULL;
+    g->shown = NULL;
+    g->shownNb = g->shownSize = 0;
+    g->query = 0;
+    s->grid = g;
+
+    // Scene order follows the list, last added polygons first
+    g->order = 0;
+    for (p = s->polygons; p; p = p->next) order++;
+    for (p = s->polygons; p; p = p->next) {
+        v4p_gridAdd(g, p);
+        p->gridItem->order = order--;
+    }
+    return success;
+}
+
+// called by v4p_rankPolygons()
+static int comparePolygonDepth(void* data1, void* data2) {
+    return ((V4pPolygonP) data1)->z < ((V4pPolygonP) data2)->z;
 }
 
-// open all new scan-line intersected ActiveEdge, returns them as a list
-List v4p_openActiveEdge(V4pCoord vy, V4pCoord yu) {
-    List newlyOpenedAEList = NULL;
+// rank visible polygons by depth once per frame
+// so that the scanline loop tracks opened polygons with a bitset of ranks, reading their colors and collision
+// masks from a dense array by rank rather than from the polygons themselves.
+// Polygons of a same layer are ranked by scene order (first met is on top).
+static int v4p_rankPolygons() {
     List l;
-    ActiveEdgeP ae;
+    int rank;
+
+    if (! v4p->rankedPolygons || ! v4p->ranks || v4p->rankedPolygonsNb > v4p->rankedPolygonsSize) {
+        v4p_free(v4p->rankedPolygons);
+        v4p_free(v4p->ranks);
+        v4p->rankedPolygonsSize = v4p->rankedPolygonsNb * 2 + 32;
+        v4p->rankedPolygons = (V4pPolygonP*) v4p_malloc(sizeof(V4pPolygonP) * v4p->rankedPolygonsSize);
+        v4p->ranks = (V4pRankedPolygon*) v4p_malloc(sizeof(V4pRankedPolygon) * v4p->rankedPolygonsSize);
+    }
+    if (! v4p->rankedPolygons || ! v4p->ranks) {
+        v4p_free(v4p->rankedPolygons);
+        v4p_free(v4p->ranks);
+        v4p->rankedPolygons = NULL;
+        v4p->ranks = NULL;
+        v4p->rankedPolygonsSize = 0;
+        for (l = v4p->visiblePolygons; l; l = ListFreeIn(v4p->listHeap, l))
+            ;
+        v4p->visiblePolygons = NULL;
+        return (v4p_error("v4p_rankPolygons failed, cannot allocate %d ranks\n", v4p->rankedPolygonsNb), failure);
+    }
 
-    V4pCoord avx, avy, bvx, bvy, dx, dy, q, r;
+    l = ListSort(v4p->visiblePolygons, comparePolygonDepth);
+    for (rank = 0; l; rank++) {
+        V4pPolygonP p = (V4pPolygonP) ListData(l);
+        p->rank = rank;
+        v4p->rankedPolygons[rank] = p;
+        v4p->ranks[rank].color = p->color;
+        v4p->ranks[rank].collisionMask = p->collisionMask;
+        l = ListFreeIn(v4p->listHeap, l);
+    }
+    v4p->visiblePolygons = NULL;
+    return success;
+}
 
-    l = QuickTableGet(v4p->openableAETable, vy & YHASH_MASK);
-    for (; l; l = l->quick) {
-        ae = (ActiveEdgeP) ListData(l);
-        avx = ae->avx;
-        avy = ae->avy;
-        bvx = ae->bvx;
-        bvy = ae->bvy;
+// Offset an arc edge at its current row: the x drain of McIlroy algorithm, in closed form
+// t is the accumulator at offset ex. Top half: ex grows to the first offset where t + b²·ex exceeds
+// -(ea + b²), bottom half: ex shrinks down to the first offset where t - 2b²·ex does not.
+static void v4p_drainArc(ActiveEdgeP ae, int64_t t, V4pCoord ex) {
+    int64_t b2 = ae->as.arc.b2, k = -((int64_t) ae->as.arc.ea + b2), q, base, n;
 
-        v4p_trace(EDGE, "Candidate %p: (%d,%d) to (%d,%d), isArc=%d\n", (void*) ae, avx, avy, bvx, bvy, ae->isArc);
+    if (b2 == 0) {  // flat ellipse
+        ae->as.arc.ex = ex;
+        ae->as.arc.t = t;
+        return;
+    }
+    if (ae->as.arc.ydir == -1) {
+        // t(n) = base + b²·(n² + n), smallest n >= ex where base + b²·(n² + 2n) > k, (n + 1)² > (k - base) / b² + 1
+        base = t - b2 * ((int64_t) ex * ex + ex);
+        q = (k - base) / b2 + 1;
+        n = (int64_t) isqrt32((uint32_t) IMIN(IMAX(q, 0), UINT32_MAX)) - 1;
+        if (n < ex) n = ex;
+        while (base + b2 * (n * n + 2 * n) <= k) n++;
+        while (n > ex && base + b2 * ((n - 1) * (n - 1) + 2 * (n - 1)) > k) n--;
+        t = base + b2 * (n * n + n);
+    } else {
+        // t(n) = base + b²·(n² - n), largest n <= ex where n = 0 or base + b²·(n² - 3n) <= k, (2n - 3)² <= 4(k - base) / b² + 9
+        base = t - b2 * ((int64_t) ex * ex - ex);
+        q = 4 * (k - base) / b2 + 9;
+        n = q > 0 ? (3 + (int64_t) isqrt32((uint32_t) IMIN(q, UINT32_MAX))) / 2 : 0;
+        if (n > ex) n = ex;
+        while (n > 0 && base + b2 * (n * n - 3 * n) > k) n--;
+        while (n < ex && base + b2 * ((n + 1) * (n + 1) - 3 * (n + 1)) <= k) n++;
+        t = base + b2 * (n * n - n);
+    }
+    ae->as.arc.ex = (V4pCoord) n;
+    ae->as.arc.t = t;
+}
+
+// Side of an arc edge, see V4pOpenedEdges
+static int8_t v4p_arcSide(ActiveEdgeP ae) {
+    V4pCoord dx = ae->avx != ae->as.arc.cvx ? ae->avx - ae->as.arc.cvx : ae->bvx - ae->as.arc.cvx;
+    return (int8_t) (SIGN(dx) * (ae->isStroke ? 2 : 1));
+}
+
+// x of an opened arc edge on a side of its ellipse, or of an opened Bezier edge (no side)
+static inline V4pCoord v4p_arcX(ActiveEdgeP ae, int8_t side) {
+    if (! side) return ae->x;
+    return ae->as.arc.cvx + SIGN(side) * (IABS(side) == 2 ? ae->as.arc.lex : ae->as.arc.ex);
+}
+
+// x of an opened Bezier edge at row y, at or below its former row
+// It steps forward to the last step point above the row, then x is interpolated along the chord to the
+// next step point.
+static V4pCoord v4p_bezierX(ActiveEdgeP ae, V4pCoord y) {
+    int64_t ty = (int64_t) y * ((int64_t) 1 << ae->as.bezier.shift), x;
+    while (ae->as.bezier.steps > 0 && ae->as.bezier.fy + ae->as.bezier.dy1 <= ty) {
+        ae->as.bezier.fx += ae->as.bezier.dx1;
+        ae->as.bezier.dx1 += ae->as.bezier.dx2;
+        ae->as.bezier.dx2 += ae->as.bezier.dx3;
+        ae->as.bezier.fy += ae->as.bezier.dy1;
+        ae->as.bezier.dy1 += ae->as.bezier.dy2;
+        ae->as.bezier.dy2 += ae->as.bezier.dy3;
+        ae->as.bezier.steps--;
+    }
+    x = ae->as.bezier.fx;
+    if (ae->as.bezier.steps > 0 && ty > ae->as.bezier.fy) {  // fy < ty < fy + dy1
+        x += (ae->as.bezier.dx1 * (((ty - ae->as.bezier.fy) << 16) / ae->as.bezier.dy1)) >> 16;
+    }
+    return (V4pCoord) ((x + ((int64_t) 1 << (ae->as.bezier.shift - 1))) >> ae->as.bezier.shift);
+}
 
-        if (vy == 0) {
-            if (avy > 0) continue;
-        } else if (avy != vy)
-            continue;
-        if (bvy <= vy) continue;
-
-        ae->h = bvy - vy - 1;
-        ae->x = avx;
-        dx = bvx - avx;
-        dy = bvy - avy;
-
-
-        if (! ae->isArc) {
-            v4p_trace(OPEN, "Opening edge %p, height=%d, dx=%d, dy=%d\n", (void*) ae, ae->h, dx, dy);
-            q = dx / dy;
-            r = IABS(dx) % dy;
-            ae->as.straight.o1 = q;
-            ae->as.straight.o2 = ae->as.straight.o1 + SIGN(dx);
-            ae->as.straight.r1 = r;
-            ae->as.straight.r2 = r - dy;
-            ae->as.straight.s = -dy / 2;
-            int dy2 = vy - avy;
-            if (dy2 > 0) {  // edge top truncation
-                ae->x += dy2 * q + dy2 * SIGN(dx) * r / dy;
-                ae->as.straight.s += (dy2 * r) % dy;
+// x of a Bezier stroke edge at row y, x being the curve x there: the curve x one row ahead, or next pixel
+static V4pCoord v4p_bezierStrokeX(ActiveEdgeP ae, V4pCoord y, V4pCoord x) {
+    ae->as.bezier.nx = v4p_bezierX(ae, y + 1);
+    return ae->as.bezier.nx != x ? ae->as.bezier.nx : x + 1;
+}
+
+// shift an opened ActiveEdge to the next scanline, returns its new x
+static inline V4pCoord v4p_shiftActiveEdge(ActiveEdgeP ae, V4pCoord vy) {
+    if (ae->isArc) {
+        // Step y offset and update McIlroy accumulator
+
+        // EV drain: step x until ellipse is tracked at new y, once then in closed form (flat arc)
+        V4pCoord pex = ae->as.arc.ex;
+        if (ae->as.arc.ydir == -1) {
+            // Top half: ey shrinking, ex grows
+            ae->as.arc.t -= (int64_t) ae->as.arc.a2 * 2 * ae->as.arc.ey;
+            ae->as.arc.ey--;
+
+            if (ae->as.arc.t + (int64_t) ae->as.arc.b2 * ae->as.arc.ex
+                 <= -(ae->as.arc.ea + ae->as.arc.b2)) {
+                ae->as.arc.ex++;
+                ae->as.arc.t += (int64_t) ae->as.arc.b2 * (2 * ae->as.arc.ex);
+                if (ae->as.arc.t + (int64_t) ae->as.arc.b2 * ae->as.arc.ex <= -(ae->as.arc.ea + ae->as.arc.b2))
+                    v4p_drainArc(ae, ae->as.arc.t, ae->as.arc.ex);
             }
-            if (ae->isStroke) {
-                // the stroke dedicated AE is a secondary AE next to the regular one so to draw a 1px line on screen
-                // it simply the same AE, but with one scanline computation ahead
-                ae->x += (q == 0 ? 1 : q);  // SIGN(IABS(dx) - dy) +
-                ae->as.straight.s += (IABS(dx) > dy ? r : 0); // += dy / 2 - 1; // += dy / 2; //  * SIGN(dy - dx);
+            if (pex != ae->as.arc.ex) {
+                ae->as.arc.lex = pex - 1;
             }
         } else {
-            // Initialize McIlroy ellipse algorithm
-            V4pCoord cvx = ae->as.arc.cvx;
-            V4pCoord cvy = ae->as.arc.cvy;
-            V4pCoord a = ae->as.arc.a;
-            V4pCoord b = ae->as.arc.b;
-            v4p_trace(OPEN, "Opening arc edge %p, (%d,%d)-(%d,%d)-(%d,%d)\n", (void*) ae, avx, avy, cvx, cvy, bvx, bvy);
-
-            // Cramer (?)
-            int dax = avx - cvx;
-            int day = avy - cvy;
-            int dbx = bvx - cvx;
-            int dby = bvy - cvy;
-            V4pCoord a2 = a * a;
-            V4pCoord b2 = b * b;
-
-            // Semi-axes in view coordinates
-            // Direction determination
-            ae->as.arc.xdir = SIGN(dax ? dax : dbx);
-            ae->as.arc.ydir = SIGN(day ? day : dby);
-            
-            // Precompute values for McIlroy algorithm
-            ae->as.arc.ea = (V4pCoord) ((a2 + 3) / 4);  // ceil(a²/4)
-
-            // Entry y offset from center
-            V4pCoord ey0 = avy - cvy;
-            ey0 = IABS(ey0);
-            ae->as.arc.ey = ey0;
-
-            // Init McIlroy t then jump to ey=ey0 in closed form
-            long t;
-            // EV drain: advance ex until ellipse is correctly tracked at entry row
-            V4pCoord ex = IABS(dax);
-            if (ae->as.arc.ydir == -1) {
-                // Top half
-                t = (long) b2 * ((long) ex * ex) + (long) a2 * ((long) ey0 * ey0) - (long) a2 * b2;
-                // small drain to correct isqrt rounding
-                while (t + b2 * (2 * ex + 1) < -(ae->as.arc.ea + b2)) {
-                    ex++;
-                    t += b2 * (2 * ex);
-                }
-                ae->as.arc.lex = ex - 1;
+            // Bottom half: ey grows, ex shrinks
+            ae->as.arc.ey++;
+            ae->as.arc.t += (int64_t) ae->as.arc.a2 * 2 * (ae->as.arc.ey + 1);
+
+            if (ae->as.arc.ex > 0
+                   && ae->as.arc.t - (int64_t) ae->as.arc.b2 * (2 * ae->as.arc.ex)
+                       > -(ae->as.arc.ea + ae->as.arc.b2)) {
+                ae->as.arc.ex--;
+                ae->as.arc.t -= (int64_t) ae->as.arc.b2 * (2 * ae->as.arc.ex);
+                if (ae->as.arc.ex > 0
+                    && ae->as.arc.t - (int64_t) ae->as.arc.b2 * (2 * ae->as.arc.ex) > -(ae->as.arc.ea + ae->as.arc.b2))
+                    v4p_drainArc(ae, ae->as.arc.t, ae->as.arc.ex);
+            }
+            if (pex != ae->as.arc.ex) {
+                ae->as.arc.lex = pex - 1;
+            }
+        }
+
+        ae->x = ae->as.arc.cvx + ae->as.arc.xdir * (ae->isStroke ? ae->as.arc.lex : ae->as.arc.ex);
+        v4p_trace(SHIFT, "Shift ellipse arc edge %p to x=%d, y=%d\n", (void*) ae, ae->x, vy);
+
+    } else if (ae->isBezier) {
+        ae->x = ae->isStroke ? v4p_bezierStrokeX(ae, vy, ae->as.bezier.nx) : v4p_bezierX(ae, vy);
+        v4p_trace(SHIFT, "Shift Bezier edge %p to x=%d, y=%d\n", (void*) ae, ae->x, vy);
+
+    } else {
+        if (ae->as.straight.o2) {
+            if (ae->as.straight.s > 0) {
+                ae->x += ae->as.straight.o2;
+                ae->as.straight.s += ae->as.straight.r2;
             } else {
-                // Bottom half
-                t = (long) b2 * ((long) ex * ex) + (long) a2 * ((long) ey0 * ey0) - (long) a2 * b2;
-                // small drain to correct isqrt rounding
-                while (ex > 0 && t - b2 * (2 * ex) > -(ae->as.arc.ea + b2)) {
-                    ex--;
-                    t -= b2 * (2 * ex);
+                ae->x += ae->as.straight.o1;
+                ae->as.straight.s += ae->as.straight.r1;
+            }
+        }
+        v4p_trace(SHIFT, "Shift edge %p (%d,%d)x(%d,%d) to x=%d, y=%d\n",
+                  (void*) ae, ae->avx, ae->avy, ae->bvx, ae->bvy, ae->x, vy);
+    }
+    return ae->x;
+}
+
+// Set an arc edge state k rows below its opening row, where ex0, ey0 and t0 were its offsets and accumulator
+static void v4p_jumpArc(ActiveEdgeP ae, int64_t t0, V4pCoord ex0, V4pCoord ey0, V4pCoord k) {
+    int64_t a2 = ae->as.arc.a2;
+    if (ae->as.arc.ydir == -1) {  // k steps of t -= 2a²·ey; ey--
+        ae->as.arc.ey = ey0 - k;
+        v4p_drainArc(ae, t0 - a2 * k * (2 * (int64_t) ey0 - k + 1), ex0);
+    } else {  // k steps of ey++; t += 2a²·(ey + 1)
+        ae->as.arc.ey = ey0 + k;
+        v4p_drainArc(ae, t0 + a2 * k * (2 * (int64_t) ey0 + k + 3), ex0);
+    }
+}
+
+// Start a Bezier edge at its top row: N steps of forward differencing from a to b
+// N is a power of 2 large enough for the chords between step points to stay within 1/8 pixel of the
+// curve, up to 1024. Step points are kept in 1/N³ pixels, so that differences are integers.
+static void v4p_startBezier(ActiveEdgeP ae) {
+    int degree = ae->as.bezier.degree;
+    int64_t px[4] = { ae->avx, ae->as.bezier.c1vx, ae->as.bezier.c2vx, ae->bvx };
+    int64_t py[4] = { ae->avy, ae->as.bezier.c1vy, ae->as.bezier.c2vy, ae->bvy };
+    if (degree == 2) {
+        px[2] = ae->bvx;
+        py[2] = ae->bvy;
+    }
+
+    // Chords flatness: the second differences of the points bound the curve second derivative
+    int64_t m = 0;
+    for (int i = 0; i + 2 <= degree; i++) {
+        m = IMAX(m, IABS(px[i] - 2 * px[i + 1] + px[i + 2]));
+        m = IMAX(m, IABS(py[i] - 2 * py[i + 1] + py[i + 2]));
+    }
+    m *= degree == 3 ? 6 : 2;
+    int s = 1;
+    while (s < 10 && ((int64_t) 1 << (2 * s)) < m) s++;
+    int64_t n = (int64_t) 1 << s;
+
+    // P(t) = a·t³ + b·t² + c·t + d, at step k: N³·P(k / N) = a·k³ + b·N·k² + c·N²·k + d·N³
+    int64_t a, b, c;
+    int64_t* f[2][4] = { { &ae->as.bezier.fx, &ae->as.bezier.dx1, &ae->as.bezier.dx2, &ae->as.bezier.dx3 },
+                         { &ae->as.bezier.fy, &ae->as.bezier.dy1, &ae->as.bezier.dy2, &ae->as.bezier.dy3 } };
+    for (int axis = 0; axis < 2; axis++) {
+        int64_t* p = axis ? py : px;
+        if (degree == 3) {
+            a = -p[0] + 3 * p[1] - 3 * p[2] + p[3];
+            b = 3 * p[0] - 6 * p[1] + 3 * p[2];
+            c = 3 * (p[1] - p[0]);
+        } else {
+            a = 0;
+            b = p[0] - 2 * p[1] + p[2];
+            c = 2 * (p[1] - p[0]);
+        }
+        *f[axis][0] = p[0] * n * n * n;
+        *f[axis][1] = a + b * n + c * n * n;
+        *f[axis][2] = 6 * a + 2 * b * n;
+        *f[axis][3] = 6 * a;
+    }
+    ae->as.bezier.steps = (V4pCoord) n;
+    ae->as.bezier.shift = (int8_t) (3 * s);
+}
+
+// initialize an ActiveEdge opened at scanline vy
+// vy is the edge top scanline, or a lower one when the edge is truncated (top of view or band)
+static void v4p_initActiveEdge(ActiveEdgeP ae, V4pCoord vy) {
+    V4pCoord avx, avy, bvx, bvy, dx, dy, q, r;
+
+    avx = ae->avx;
+    avy = ae->avy;
+    bvx = ae->bvx;
+    bvy = ae->bvy;
+
+    ae->x = avx;
+    dx = bvx - avx;
+    dy = bvy - avy;
+
+    if (ae->isBezier) {
+        v4p_trace(OPEN, "Opening Bezier edge %p, (%d,%d)-(%d,%d)\n", (void*) ae, avx, avy, bvx, bvy);
+        v4p_startBezier(ae);
+        ae->x = v4p_bezierX(ae, vy);  // stepped down at once when truncated
+        if (ae->isStroke) ae->x = v4p_bezierStrokeX(ae, vy, ae->x);
+    } else if (! ae->isArc) {
+        v4p_trace(OPEN, "Opening edge %p, height=%d, dx=%d, dy=%d\n", (void*) ae, bvy - vy - 1, dx, dy);
+        q = dx / dy;
+        r = IABS(dx) % dy;
+        ae->as.straight.o1 = q;
+        ae->as.straight.o2 = ae->as.straight.o1 + SIGN(dx);
+        ae->as.straight.r1 = r;
+        ae->as.straight.r2 = r - dy;
+        ae->as.straight.s = -dy / 2;
+        if (ae->isStroke) {
+            // the stroke dedicated AE is a secondary AE next to the regular one so to draw a 1px line on screen
+            // it simply the same AE, but with one scanline computation ahead
+            ae->x += (q == 0 ? 1 : q);  // SIGN(IABS(dx) - dy) +
+            ae->as.straight.s += (IABS(dx) > dy ? r : 0); // += dy / 2 - 1; // += dy / 2; //  * SIGN(dy - dx);
+        }
+        V4pCoord k = vy - avy;
+        if (k > 0) {  // edge top truncation, same as k shifts
+            // after a first shift, s stays within [r - dy + 1, r], hence the count of o2 offsets
+            int64_t c = ((int64_t) ae->as.straight.s + (int64_t) (k - 1) * r + dy - 1) / dy;
+            ae->x += k * q + SIGN(dx) * (V4pCoord) c;
+            ae->as.straight.s += (V4pCoord) ((int64_t) k * r - c * dy);
+        }
+    } else {
+        // Initialize McIlroy ellipse algorithm
+        V4pCoord cvx = ae->as.arc.cvx;
+        V4pCoord cvy = ae->as.arc.cvy;
+        V4pCoord a = ae->as.arc.a;
+        V4pCoord b = ae->as.arc.b;
+        v4p_trace(OPEN, "Opening arc edge %p, (%d,%d)-(%d,%d)-(%d,%d)\n", (void*) ae, avx, avy, cvx, cvy, bvx, bvy);
+
+        // Cramer (?)
+        int dax = avx - cvx;
+        int day = avy - cvy;
+        int dbx = bvx - cvx;
+        int dby = bvy - cvy;
+        V4pCoord a2 = a * a;
+        V4pCoord b2 = b * b;
+
+        // Semi-axes in view coordinates
+        // Direction determination
+        ae->as.arc.xdir = SIGN(dax ? dax : dbx);
+        ae->as.arc.ydir = SIGN(day ? day : dby);
+
+        // Precompute values for McIlroy algorithm
+        ae->as.arc.ea = (V4pCoord) ((a2 + 3) / 4);  // ceil(a²/4)
+
+        // Entry y offset from center
+        V4pCoord ey0 = avy - cvy;
+        ey0 = IABS(ey0);
+        ae->as.arc.ey = ey0;
+
+        // Init McIlroy t then jump to ey=ey0 in closed form
+        int64_t t;
+        // EV drain: advance ex until ellipse is correctly tracked at entry row
+        V4pCoord ex = IABS(dax);
+        if (ae->as.arc.ydir == -1) {
+            // Top half
+            t = (int64_t) b2 * ex * ex + (int64_t) a2 * ey0 * ey0 - (int64_t) a2 * b2;
+            // small drain to correct isqrt rounding
+            while (t + (int64_t) b2 * (2 * ex + 1) < -(ae->as.arc.ea + b2)) {
+                ex++;
+                t += (int64_t) b2 * (2 * ex);
+            }
+            ae->as.arc.lex = ex - 1;
+        } else {
+            // Bottom half
+            t = (int64_t) b2 * ex * ex + (int64_t) a2 * ey0 * ey0 - (int64_t) a2 * b2;
+            // small drain to correct isqrt rounding
+            while (ex > 0 && t - (int64_t) b2 * (2 * ex) > -(ae->as.arc.ea + b2)) {
+                ex--;
+                t -= (int64_t) b2 * (2 * ex);
+            }
+            ae->as.arc.lex = ex - 1;
+        }
+        ae->as.arc.ex = ex;
+        ae->as.arc.t = t;
+
+        // Set initial x
+        ae->x = cvx + ae->as.arc.xdir * ex;
+        v4p_trace(OPEN, "Opening ellipse arc edge %p, center=(%d,%d), a=%d, b=%d\n", (void*) ae,
+                    ae->as.arc.cvx, ae->as.arc.cvy, ae->as.arc.a, ae->as.arc.b);
+        v4p_trace(OPEN, "  Arc attributes: (%d,%d)-(%d,%d)-(%d,%d) cx=%d, cy=%d, a2=%d, b2=%d, ea=%d, t=%lld, ex=%d, ey=%d, xdir=%d, ydir=%d\n",
+                    ae->avx, ae->avy, ae->as.arc.cvx, ae->as.arc.cvy, ae->bvx, ae->bvy,
+                    ae->as.arc.cx, ae->as.arc.cy, ae->as.arc.a2, ae->as.arc.b2, ae->as.arc.ea,
+                    (long long) ae->as.arc.t, ae->as.arc.ex, ae->as.arc.ey, ae->as.arc.xdir, ae->as.arc.ydir);
+
+        // edge top truncation: jump the arc down to the opening scanline
+        V4pCoord k = vy - avy;
+        if (k > 0) {
+            V4pCoord ex0 = ex;
+            v4p_jumpArc(ae, t, ex0, ey0, k);
+            if ((ae->isStroke || ae->rider) && ae->as.arc.ex != ex0) {
+                // lex is the offset before the last change of ex: search the row of this change
+                V4pCoord last = ae->as.arc.ex, lo = 1, hi = k;
+                while (lo < hi) {
+                    V4pCoord mid = (lo + hi) / 2;
+                    v4p_jumpArc(ae, t, ex0, ey0, mid);
+                    if (ae->as.arc.ex == last) hi = mid; else lo = mid + 1;
                 }
-                ae->as.arc.lex = ex - 1;
+                if (lo > 1) v4p_jumpArc(ae, t, ex0, ey0, lo - 1);
+                ae->as.arc.lex = (lo > 1 ? ae->as.arc.ex : ex0) - 1;
+                v4p_jumpArc(ae, t, ex0, ey0, k);
             }
-            ae->as.arc.ex = ex;
-            ae->as.arc.t = (V4pCoord) t;
-
-            // Set initial x
-            ae->x = cvx + ae->as.arc.xdir * ex;
-            v4p_trace(OPEN, "Opening ellipse arc edge %p, center=(%d,%d), a=%d, b=%d\n", (void*) ae,
-                        ae->as.arc.cvx, ae->as.arc.cvy, ae->as.arc.a, ae->as.arc.b);
-            v4p_trace(OPEN, "  Arc attributes: (%d,%d)-(%d,%d)-(%d,%d) cx=%d, cy=%d, a2=%d, b2=%d, ea=%d, t=%d, ex=%d, ey=%d, xdir=%d, ydir=%d\n",
-                        ae->avx, ae->avy, ae->as.arc.cvx, ae->as.arc.cvy, ae->bvx, ae->bvy,
-                        ae->as.arc.cx, ae->as.arc.cy, ae->as.arc.a2, ae->as.arc.b2, ae->as.arc.ea,
-                        ae->as.arc.t, ae->as.arc.ex, ae->as.arc.ey, ae->as.arc.xdir, ae->as.arc.ydir);
+            ae->x = cvx + ae->as.arc.xdir * (ae->isStroke ? ae->as.arc.lex : ae->as.arc.ex);
         }
-        ListPrepend(newlyOpenedAEList, ae);
     }
-    if (newlyOpenedAEList) newlyOpenedAEList = v4p_sortActiveEdge(newlyOpenedAEList);
-    return newlyOpenedAEList;
+    ae->h = bvy - vy - 1;
+}
+
+// Grow the opened edge arrays of a band
+// Arrays grown before a failure are merely larger than needed.
+#define V4P_GROW(ARRAY, SIZE) \
+    do { \
+        void* a = v4p_realloc(ARRAY, sizeof(*(ARRAY)) * (SIZE)); \
+        if (! a) return (v4p_error("v4p_growOpenedEdges failed, cannot allocate %d edges\n", SIZE), failure); \
+        ARRAY = a; \
+    } while (0)
+
+static int v4p_growOpenedEdges(V4pOpenedEdges* e) {
+    int size = e->slotsSize * 2 + 64;
+    V4P_GROW(e->order, size);
+    V4P_GROW(e->merged, size);
+    V4P_GROW(e->freeSlots, size);
+    V4P_GROW(e->x, size);
+    V4P_GROW(e->h, size);
+    V4P_GROW(e->o1, size);
+    V4P_GROW(e->o2, size);
+    V4P_GROW(e->s, size);
+    V4P_GROW(e->r1, size);
+    V4P_GROW(e->r2, size);
+    V4P_GROW(e->rank, size);
+    V4P_GROW(e->arc, size);
+    V4P_GROW(e->side, size);
+    e->slotsSize = size;
+    return success;
 }
 
-// Render a scene
-int v4p_render() {
-    v4p_trace(SCAN, "v4p_render\n");
-    
-    List l, pl;
-    ActiveEdgeP ae;
-    V4pPolygonP p; // b->p
-    V4pLayer z;  // p->z
-    V4pCoord vx, vy;  // x, y in screen coordinates
-    V4pCoord pvx, px_collide;
+static int v4p_growOpenedArcs(V4pOpenedEdges* e) {
+    int size = e->arcsSize * 2 + 16;
+    V4P_GROW(e->arcs, size);
+    V4P_GROW(e->arcUsers, size);
+    V4P_GROW(e->freeArcs, size);
+    e->arcsSize = size;
+    return success;
+}
 
-    V4pCoord y; // y in scene cordinates corresponding to vy (line y on screen)
-    int su, ou1, ou2, ru1, ru2;
+#undef V4P_GROW
 
-    V4pPolygonP visiblePolygon;  // Visible (opened at top) polygon
+// Take a slot for an edge being opened, with a copy for an arc or Bezier edge, returns -1 when out of memory
+static int v4p_takeEdgeSlot(V4pOpenedEdges* e, bool curved) {
+    int i;
+    if (e->freeSlotsNb > 0) {
+        i = e->freeSlots[--e->freeSlotsNb];
+    } else {
+        if (e->slotsNb == e->slotsSize && v4p_growOpenedEdges(e)) return -1;
+        i = e->slotsNb++;
+    }
+    e->arc[i] = -1;
+    if (curved) {
+        if (e->freeArcsNb > 0) {
+            e->arc[i] = e->freeArcs[--e->freeArcsNb];
+        } else if (e->arcsNb < e->arcsSize || ! v4p_growOpenedArcs(e)) {
+            e->arc[i] = e->arcsNb++;
+        } else {
+            e->freeSlots[e->freeSlotsNb++] = i;
+            return -1;
+        }
+        e->arcUsers[e->arc[i]] = 1;
+    }
+    return i;
+}
+
+// Give the slot of a closed edge back
+static inline void v4p_releaseEdgeSlot(V4pOpenedEdges* e, int i) {
+    if (e->arc[i] >= 0 && --e->arcUsers[e->arc[i]] == 0) e->freeArcs[e->freeArcsNb++] = e->arc[i];
+    e->freeSlots[e->freeSlotsNb++] = i;
+    e->o1[i] = e->o2[i] = e->r1[i] = e->r2[i] = 0;  // stepped along harmlessly
+}
+
+// Step the straight opened edges of a band to the next scanline
+// Each x moves by o2 and s by r2 when s > 0, otherwise by o1 and r1 (see v4p_shiftActiveEdge).
+// All slots are stepped at once, several per instruction with SIMD, and each h is decremented.
+static void v4p_stepEdges(V4pOpenedEdges* e) {
+    V4pCoord *x = e->x, *h = e->h, *o1 = e->o1, *o2 = e->o2, *s = e->s, *r1 = e->r1, *r2 = e->r2;
+    int i = 0, n = e->slotsNb;
+#if defined(V4P_SIMD_AVX2)
+    const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi32(1);
+    for (; i + 8 <= n; i += 8) {
+        __m256i vs = _mm256_loadu_si256((__m256i*) (s + i));
+        __m256i up = _mm256_cmpgt_epi32(vs, zero);
+        __m256i o = _mm256_blendv_epi8(_mm256_loadu_si256((__m256i*) (o1 + i)), _mm256_loadu_si256((__m256i*) (o2 + i)), up);
+        __m256i r = _mm256_blendv_epi8(_mm256_loadu_si256((__m256i*) (r1 + i)), _mm256_loadu_si256((__m256i*) (r2 + i)), up);
+        _mm256_storeu_si256((__m256i*) (x + i), _mm256_add_epi32(_mm256_loadu_si256((__m256i*) (x + i)), o));
+        _mm256_storeu_si256((__m256i*) (s + i), _mm256_add_epi32(vs, r));
+        _mm256_storeu_si256((__m256i*) (h + i), _mm256_sub_epi32(_mm256_loadu_si256((__m256i*) (h + i)), one));
+    }
+#elif defined(V4P_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi32(1);
+    for (; i + 4 <= n; i += 4) {
+        __m128i vs = _mm_loadu_si128((__m128i*) (s + i));
+        __m128i up = _mm_cmpgt_epi32(vs, zero);
+        __m128i o = _mm_or_si128(_mm_and_si128(up, _mm_loadu_si128((__m128i*) (o2 + i))),
+                                 _mm_andnot_si128(up, _mm_loadu_si128((__m128i*) (o1 + i))));
+        __m128i r = _mm_or_si128(_mm_and_si128(up, _mm_loadu_si128((__m128i*) (r2 + i))),
+                                 _mm_andnot_si128(up, _mm_loadu_si128((__m128i*) (r1 + i))));
+        _mm_storeu_si128((__m128i*) (x + i), _mm_add_epi32(_mm_loadu_si128((__m128i*) (x + i)), o));
+        _mm_storeu_si128((__m128i*) (s + i), _mm_add_epi32(vs, r));
+        _mm_storeu_si128((__m128i*) (h + i), _mm_sub_epi32(_mm_loadu_si128((__m128i*) (h + i)), one));
+    }
+#elif defined(V4P_SIMD_NEON)
+    const int32x4_t zero = vdupq_n_s32(0), one = vdupq_n_s32(1);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t vs = vld1q_s32(s + i);
+        uint32x4_t up = vcgtq_s32(vs, zero);
+        vst1q_s32(x + i, vaddq_s32(vld1q_s32(x + i), vbslq_s32(up, vld1q_s32(o2 + i), vld1q_s32(o1 + i))));
+        vst1q_s32(s + i, vaddq_s32(vs, vbslq_s32(up, vld1q_s32(r2 + i), vld1q_s32(r1 + i))));
+        vst1q_s32(h + i, vsubq_s32(vld1q_s32(h + i), one));
+    }
+#endif
+    for (; i < n; i++) {
+        if (s[i] > 0) {
+            x[i] += o2[i];
+            s[i] += r2[i];
+        } else {
+            x[i] += o1[i];
+            s[i] += r1[i];
+        }
+        h[i]--;
+    }
+}
 
-    V4pPolygonP concretePolygons[32];  // Concrete active polygon per layer
-    uint32_t concreteBitmask;  // Bitmask of layer with active concrete polygon
+// Merge the slots ordered by x in order[from, mid) and order[mid, to), the former first at equal x
+static void v4p_mergeEdges(V4pOpenedEdges* e, int from, int mid, int to) {
+    int i = from, j = mid, k = from;
+    int* order = e->order;
+    if (i == mid || j == to || e->x[order[mid - 1]] <= e->x[order[mid]]) return;  // already ordered
+    while (i < mid && j < to) e->merged[k++] = (e->x[order[j]] < e->x[order[i]]) ? order[j++] : order[i++];
+    while (i < mid) e->merged[k++] = order[i++];
+    for (i = from; i < k; i++) order[i] = e->merged[i];  // order[j, to) is in place
+}
 
-    v4pi_setContext(v4p->display);
+// Sort the slots of order[from, to) by x, slots of equal x keeping their order
+static void v4p_sortEdges(V4pOpenedEdges* e, int from, int to) {
+    for (int width = 1; width < to - from; width *= 2) {
+        for (int i = from; i + width < to; i += 2 * width) v4p_mergeEdges(e, i, i + width, IMIN(i + 2 * width, to));
+    }
+}
 
-    v4pi_start();
+// open all new scan-line intersected ActiveEdges of a band, appending them to its opened edges
+// At the first scanline of a band, ActiveEdges crossing it from above are opened too.
+// ActiveEdges are shared by bands, they are opened in private arrays and copies.
+static int v4p_openActiveEdge(V4pBand* band, V4pCoord vy) {
+    V4pOpenedEdges* e = &band->edges;
+    List l;
+    ActiveEdgeP ae;
+    V4pCoord i = vy;
 
-    // Update AE lists and build an y-index hash table
-    QuickTableReset(v4p->openableAETable);
-    v4p_buildOpenableAELists(v4p->scene->polygons);
+    if (vy == band->y0) {  // edges crossing the band top may start at any row above, or above the view
+        i = -1;
+    }
+    for (; i <= vy; i++) {
+        for (l = QuickTableGet(v4p->openableAETable, i < 0 ? V4P_ABOVE_VIEW : i); l; l = l->quick) {
+            ae = (ActiveEdgeP) ListData(l);
 
-    // List of opened ActiveEdges
-    v4p->openedAEList = NULL;
+            v4p_trace(EDGE, "Candidate %p: (%d,%d) to (%d,%d), isArc=%d, isBezier=%d\n", (void*) ae, ae->avx,
+                      ae->avy, ae->bvx, ae->bvy, ae->isArc, ae->isBezier);
+
+            if (ae->bvy <= vy) continue;  // closed above the band
+
+            bool curved = ae->isArc || ae->isBezier;
+            int slot = v4p_takeEdgeSlot(e, curved);
+            if (slot < 0) return failure;
+            ActiveEdge straight;
+            ActiveEdgeP opened = curved ? &e->arcs[e->arc[slot]] : &straight;
+            *opened = *ae;
+            v4p_initActiveEdge(opened, vy);
+            e->x[slot] = opened->x;
+            e->h[slot] = opened->h;
+            if (! curved) {
+                e->o1[slot] = straight.as.straight.o1;
+                e->o2[slot] = straight.as.straight.o2;
+                e->s[slot] = straight.as.straight.s;
+                e->r1[slot] = straight.as.straight.r1;
+                e->r2[slot] = straight.as.straight.r2;
+            } else {  // stepped in its copy
+                e->o1[slot] = e->o2[slot] = e->r1[slot] = e->r2[slot] = 0;
+                e->side[slot] = ae->isArc ? v4p_arcSide(opened) : 0;
+            }
+            e->rank[slot] = ae->p->rank;
+            e->order[e->orderNb++] = slot;
+            v4p_count(band->stats, edgesOpened, 1);
+
+            for (ActiveEdgeP r = ae->rider; r; r = r->rider) {  // sharing the arc copy
+                int shared = v4p_takeEdgeSlot(e, false);
+                if (shared < 0) return failure;
+                int8_t side = v4p_arcSide(r);
+                e->arc[shared] = e->arc[slot];
+                e->arcUsers[e->arc[slot]]++;
+                e->side[shared] = side;
+                e->x[shared] = v4p_arcX(opened, vy > ae->avy ? side : SIGN(side));  // stroke lags once shifted
+                e->h[shared] = opened->h;
+                e->o1[shared] = e->o2[shared] = e->r1[shared] = e->r2[shared] = 0;
+                e->rank[shared] = e->rank[slot];
+                e->order[e->orderNb++] = shared;
+                v4p_count(band->stats, edgesOpened, 1);
+            }
+        }
+    }
+    return success;
+}
 
-    // yu (scanline y in absolute coordinates) progression during scanline loop
-    ou1 = v4p->viewToScreen_wholeY;
-    ou2 = v4p->viewToScreen_wholeY + 1;
-    y = v4p->viewMinY - ou2;
-    ru1 = v4p->viewToScreen_remY;
-    ru2 = v4p->viewToScreen_remY - v4p_displayHeight;
-    su = v4p->viewToScreen_remY;
+// Order opened edges by x again
+// order[0, from) was ordered at previous scanline, before edges were shifted and crossed each other,
+// and order[from, orderNb) holds newly opened edges. Crossings being mostly swaps of neighbors, the
+// former are repaired by insertion while the latter are merged in, in a single pass from the right,
+// in place. The pass stops once no edge is left to merge, unless some edges crossed. Past as many
+// moves as edges, the repair gives way to a merge sort.
+static void v4p_orderEdges(V4pOpenedEdges* e, int from, bool crossed) {
+    int *order = e->order, *added = e->merged;
+    V4pCoord* x = e->x;
+    int n = e->orderNb, moves = 0, i, j, w, p;
+
+    v4p_sortEdges(e, from, n);  // newly opened edges
+    for (j = from; j < n; j++) added[j - from] = order[j];
+    j = n - from - 1;  // last added edge to merge
+    w = n - 1;  // last position to fill
+    for (i = from - 1; i >= 0 && (j >= 0 || crossed); i--) {
+        int slot = order[i];
+        while (j >= 0 && x[added[j]] >= x[slot]) order[w--] = added[j--];
+        for (p = w--; p < n - 1 && x[order[p + 1]] < x[slot]; p++) order[p] = order[p + 1];
+        order[p] = slot;
+        moves += p - w - 1;
+        if (moves > n) {  // too many crossings
+            while (j >= 0) order[w--] = added[j--];
+            v4p_sortEdges(e, 0, n);
+            return;
+        }
+    }
+    while (j >= 0) order[w--] = added[j--];
+}
+
+// Get render statistics of the current context
+const V4pRenderStats* v4p_getRenderStats() {
+    return &v4p->stats;
+}
+
+// Reset render statistics of the current context
+void v4p_resetRenderStats() {
+    v4p_memset(&v4p->stats, 0, sizeof(V4pRenderStats));
+}
+
+// Sum render statistics
+static void v4p_addRenderStats(V4pRenderStats* to, const V4pRenderStats* from) {
+    to->totalTime += from->totalTime;
+    to->buildTime += from->buildTime;
+    to->openTime += from->openTime;
+    to->shiftTime += from->shiftTime;
+    to->sortTime += from->sortTime;
+    to->depthTime += from->depthTime;
+    to->sliceTime += from->sliceTime;
+    to->frames += from->frames;
+    to->edgesBuilt += from->edgesBuilt;
+    to->edgesOpened += from->edgesOpened;
+    to->edgesClosed += from->edgesClosed;
+    to->sorts += from->sorts;
+    to->depthInserts += from->depthInserts;
+    to->depthDeletes += from->depthDeletes;
+    to->slices += from->slices;
+    to->rowsSkipped += from->rowsSkipped;
+    to->collisions += from->collisions;
+}
+
+// Set the number of threads rendering the current context
+int v4p_setRenderThreads(int n) {
+#ifdef V4P_THREADS
+    v4p->threads = n < 1 ? 1 : n;
+#else
+    (void) n;
+    v4p->threads = 1;  // built without THREADS=1
+#endif
+    return v4p->threads;
+}
+
+#ifdef V4PI_PARTIAL
+// Does a row show these spans (spans being adjacent from x=0, their ends and colors tell them all)
+static bool v4p_isDrawn(const V4pDrawnRow* row, const V4pSpan* spans, int n) {
+    if (row->spansNb != n) return false;
+    for (int i = 0; i < n; i++) {
+        if (row->spans[i].x1 != spans[i].x1 || row->spans[i].c != spans[i].c) return false;
+    }
+    return true;
+}
 
-    // Scan-line loop
-    for (vy = 0; vy < v4p_displayHeight; vy++) {
-        bool sortNeeded = false;
+// Keep the spans drawn in a row, the row content being unknown if they cannot be kept
+static void v4p_keepDrawn(V4pDrawnRow* row, const V4pSpan* spans, int n) {
+    if (n > row->spansSize) {
+        int size = n + n / 2 + 4;
+        V4pSpan* kept = v4p_realloc(row->spans, sizeof(V4pSpan) * size);
+        if (! kept) {
+            row->spansNb = -1;
+            return;
+        }
+        row->spans = kept;
+        row->spansSize = size;
+    }
+    for (int i = 0; i < n; i++) row->spans[i] = spans[i];
+    row->spansNb = n;
+}
+#endif
+
+// Hand the spans of a scanline over to the backend
+// Backends keeping their pixels are not given scanlines they already show.
+static void v4p_flushSpans(V4pRenderStats* stats, V4pCoord y, const V4pSpan* spans, int n) {
+#ifdef V4PI_PARTIAL
+    if (v4p->drawnRows) {
+        V4pDrawnRow* row = &v4p->drawnRows[y];
+        if (v4p_isDrawn(row, spans, n)) {
+            v4p_count(*stats, rowsSkipped, 1);
+            return;
+        }
+        v4p_keepDrawn(row, spans, n);
+    }
+#endif
+    v4p_timerStart(t0);
+#ifdef V4PI_SPANS
+    v4pi_spans(y, spans, n);
+#else
+    for (int i = 0; i < n; i++) v4pi_slice(y, spans[i].x0, spans[i].x1, spans[i].c);
+#endif
+    v4p_timerStop(*stats, sliceTime, t0);
+    v4p_count(*stats, slices, n);
+}
+
+// Append a slice to the band spans, merging it with the previous span of same color
+static inline void v4p_slice(V4pBand* band, V4pCoord x0, V4pCoord x1, V4pColor c) {
+    if (x1 <= x0) return;
+    V4pSpan* span = band->spans + band->spansNb;
+    if (band->spansNb > band->rowStart && span[-1].c == c) {
+        span[-1].x1 = x1;  // slices are adjacent
+    } else {
+        span->x0 = x0;
+        span->x1 = x1;
+        span->c = c;
+        band->spansNb++;
+    }
+}
 
-        if (su >= 0) {
-            su += ru2;
-            y += ou2;
-        } else {
-            su += ru1;
-            y += ou1;
+// Report a collision, right away or buffered until the band is flushed
+static void v4p_collide(V4pBand* band, V4pCollisionLayer i1, V4pCollisionLayer i2, V4pCoord y, V4pCoord x1,
+                        V4pCoord x2, V4pPolygonP p1, V4pPolygonP p2) {
+    v4p_count(band->stats, collisions, 1);
+    if (! band->buffered) {
+        v4p->collisionCallback(i1, i2, y, x1, x2, p1, p2);
+        return;
+    }
+    if (band->collisionsNb == band->collisionsSize) {
+        int size = band->collisionsSize * 2 + 64;
+        V4pCollision* collisions = v4p_realloc(band->collisions, sizeof(V4pCollision) * size);
+        if (! collisions) {
+            band->failed = true;
+            return;
         }
+        band->collisions = collisions;
+        band->collisionsSize = size;
+    }
+    V4pCollision* c = &band->collisions[band->collisionsNb++];
+    c->i1 = i1;
+    c->i2 = i2;
+    c->y = y;
+    c->x1 = x1;
+    c->x2 = x2;
+    c->p1 = p1;
+    c->p2 = p2;
+}
+
+// Make room for the spans of one more scanline (spans are non-empty, so one per pixel at most)
+static int v4p_reserveSpans(V4pBand* band) {
+    if (band->spansSize - band->spansNb >= v4p_displayWidth) return success;
+
+    int size = band->spansNb + v4p_displayWidth;
+    if (band->buffered) size += size / 2;
+    V4pSpan* spans = v4p_realloc(band->spans, sizeof(V4pSpan) * size);
+    if (! spans) {
+        return (v4p_error("v4p_reserveSpans failed, cannot allocate %d spans\n", size), failure);
+    }
+    band->spans = spans;
+    band->spansSize = size;
+    return success;
+}
 
-        v4p_trace(SCAN, "Render yv=%d y=%d\n", vy, y);
+// Render the scanlines of a band
+static void v4p_renderBand(V4pBand* band) {
+    V4pOpenedEdges* e = &band->edges;
+    const V4pRankedPolygon* ranks = v4p->ranks;
+    int i, k, n;
+    V4pCoord vx, vy;  // x, y in screen coordinates
+    V4pCoord pvx, px_collide;
 
-        // Loop among opened ActiveEdge
-        l = v4p->openedAEList;
-        pl = NULL;
-        pvx = -(0x7FFF);  // Not sure its really the min, but we dont care
-        while (l) {
-            ae = (ActiveEdgeP) ListData(l);
-            if (ae->h <= 0) {  // Close ActiveEdge
-                v4p_trace(OPEN, "Closing edge %p at y=%d\n", (void*) ae, vy);
-                if (pl) {
-                    ListSetNext(pl, l = ListFree(l));
-                } else {
-                    v4p->openedAEList = l = ListFree(l);
-                }
-            } else {  // Shift ActiveEdge
-                ae->h--;
-                if (ae->isArc) {
-                    // Step y offset and update McIlroy accumulator
-
-                    // EV drain: step x until ellipse is tracked at new y
-                    V4pCoord pex = ae->as.arc.ex;
-                    if (ae->as.arc.ydir == -1) {
-                        // Top half: ey shrinking, ex grows
-                        ae->as.arc.t -= ae->as.arc.a2 * 2 * ae->as.arc.ey;
-                        ae->as.arc.ey--;
-
-                        while (ae->as.arc.t + ae->as.arc.b2 * ae->as.arc.ex
-                             <= -(ae->as.arc.ea + ae->as.arc.b2)) {
-                            ae->as.arc.ex++;
-                            ae->as.arc.t += ae->as.arc.b2 * (2 * ae->as.arc.ex);
-                        }
-                        if (pex != ae->as.arc.ex) {
-                            ae->as.arc.lex = pex - 1;
-                        }
-                    } else {
-                        // Bottom half: ey grows, ex shrinks
-                        ae->as.arc.ey++;
-                        ae->as.arc.t += ae->as.arc.a2 * 2 * (ae->as.arc.ey + 1);
-
-                        while (ae->as.arc.ex > 0
-                               && ae->as.arc.t - ae->as.arc.b2 * (2 * ae->as.arc.ex)
-                                   > -(ae->as.arc.ea + ae->as.arc.b2)) {
-                            ae->as.arc.ex--;
-                            ae->as.arc.t -= ae->as.arc.b2 * (2 * ae->as.arc.ex);
-                        }
-                        if (pex != ae->as.arc.ex) {
-                            ae->as.arc.lex = pex - 1;
-                        }
-                    }
+    V4pColor visibleColor;  // Color of the visible (opened at top) polygon, or background
+    int visibleRank;  // Rank of the visible polygon, -1 if none
 
-                    ae->x = ae->as.arc.cvx + ae->as.arc.xdir * (ae->isStroke ? ae->as.arc.lex : ae->as.arc.ex);
-                    vx = ae->x;
+    V4pPolygonP concretePolygons[32];  // Concrete active polygon per layer
+    uint32_t concreteBitmask;  // Bitmask of layer with active concrete polygon
 
-                    v4p_trace(SHIFT, "Shift ellipse arc edge %p to x=%d, y=%d\n", (void*) ae, vx, vy);
+    // Scan-line loop
+    for (vy = band->y0; vy < band->y1; vy++) {
+        bool sortNeeded = false;
 
-                } else {
-                    if (ae->as.straight.o2) {
-                        if (ae->as.straight.s > 0) {
-                            vx = ae->x += ae->as.straight.o2;
-                            ae->as.straight.s += ae->as.straight.r2;
-                        } else {
-                            vx = ae->x += ae->as.straight.o1;
-                            ae->as.straight.s += ae->as.straight.r1;
-                        }
-                    } else {
-                        vx = ae->x;
-                    }
-                    v4p_trace(SHIFT, "Shift edge %p (%d,%d)x(%d,%d) to x=%d, y=%d\n",
-                              (void*) ae, ae->avx, ae->avy, ae->bvx, ae->bvy, vx, vy);
-                }
+        v4p_trace(SCAN, "Render yv=%d\n", vy);
 
-                sortNeeded |= (vx < pvx);
-                pvx = vx;
-                pl = l;
-                l = ListNext(l);
+        // Shift opened ActiveEdges, straight ones all at once, then drop closed ones in x order
+        v4p_timerStart(shiftStart);
+        v4p_stepEdges(e);
+        for (k = 0; k < e->arcsNb; k++) {  // arc copies, once for all the slots sharing them
+            if (e->arcUsers[k] && --e->arcs[k].h >= 0) v4p_shiftActiveEdge(&e->arcs[k], vy);
+        }
+        pvx = -(0x7FFF);  // Not sure its really the min, but we dont care
+        for (k = n = 0; k < e->orderNb; k++) {
+            i = e->order[k];
+            if (e->h[i] < 0) {  // Close ActiveEdge (no scanline remained)
+                v4p_trace(OPEN, "Closing edge %d at y=%d\n", i, vy);
+                v4p_count(band->stats, edgesClosed, 1);
+                v4p_releaseEdgeSlot(e, i);
+                continue;
             }
+            if (e->arc[i] >= 0) e->x[i] = v4p_arcX(&e->arcs[e->arc[i]], e->side[i]);
+            vx = e->x[i];
+            v4p_trace(SHIFT, "Shift edge %d to x=%d, y=%d\n", i, vx, vy);
+            sortNeeded |= (vx < pvx);
+            pvx = vx;
+            e->order[n++] = i;
         }  // Opened ActiveEdge loop
+        e->orderNb = n;
+        v4p_timerStop(band->stats, shiftTime, shiftStart);
 
-        // Sort ActiveEdge
-        if (sortNeeded) {
-            v4p->openedAEList = v4p_sortActiveEdge(v4p->openedAEList);
+        // Open newly intersected ActiveEdge
+        v4p_timerStart(openStart);
+        int opened = e->orderNb;
+        int rc = v4p_openActiveEdge(band, vy);
+        v4p_timerStop(band->stats, openTime, openStart);
+        if (rc) {
+            band->failed = true;
+            break;
         }
 
-        // Open newly intersected ActiveEdge
-        List newlyOpenedAEList = v4p_openActiveEdge(vy, y);
-        if (newlyOpenedAEList) {
-            ListSetCompareFunc(compareActiveEdgeX);
-            v4p->openedAEList
-                = (v4p->openedAEList ? ListMerge(v4p->openedAEList, newlyOpenedAEList) : newlyOpenedAEList);
+        // Sort ActiveEdge, merging newly opened ones
+        if (sortNeeded || e->orderNb > opened) {
+            v4p_timerStart(sortStart);
+            v4p_orderEdges(e, opened, sortNeeded);
+            v4p_timerStop(band->stats, sortTime, sortStart);
+            if (sortNeeded) v4p_count(band->stats, sorts, 1);
         }
 
-        // Reset depth tree for opened polygons (keep AVL tree for depth management)
-        TreeReset(v4p->openedPolygons);
+        // Clear opened polygons left by unbalanced paths at previous scanline
+        if (! QuickBitsetIsEmpty(band->openedPolygons)) {
+            QuickBitsetReset(band->openedPolygons);
+        }
 
         // Reset concrete polygons
         v4p_memset(concretePolygons, 0, sizeof(concretePolygons));
         concreteBitmask = 0;
 
         // Reset visible polygon
-        visiblePolygon = NULL;
+        visibleColor = v4p->background;
+        visibleRank = -1;
+
+        // Room for the spans of this scanline
+        if (v4p_reserveSpans(band)) {
+            band->failed = true;
+            break;
+        }
+        band->rowStart = band->spansNb;
 
         // Loop among active edges
         pvx = px_collide = 0;
-        for (l = v4p->openedAEList; l; l = ListNext(l)) {
-            ae = (ActiveEdgeP) ListData(l);
-            vx = ae->x;
-            p = ae->p;
-            V4pLayer depth = p->z;  // Full uint32_t depth support
+        for (k = 0; k < e->orderNb; k++) {
+            i = e->order[k];
+            vx = e->x[i];
 
             if (vx > 0 && pvx < vx) {  // slice before current edge
-                v4pi_slice(vy, pvx, IMIN(vx, v4p_displayWidth), visiblePolygon ? visiblePolygon->color : v4p->background);
+                v4p_slice(band, pvx, IMIN(vx, v4p_displayWidth), visibleColor);
                 pvx = vx;
             }
 
@@ -1579,31 +3236,40 @@ int v4p_render() {
                     V4pCollisionLayer secondLayer = floorLog2(bitmaskMinusTop);
                     V4pPolygonP topConcrete = concretePolygons[topLayer];
                     V4pPolygonP secondConcrete = concretePolygons[secondLayer];
-                    // Note collisionCallback != NULL since bitmask != 0
-                    collisionCallback(topLayer, secondLayer, vy, px_collide, vx, topConcrete, secondConcrete);
+                    // Note v4p->collisionCallback != NULL since bitmask != 0
+                    v4p_collide(band, topLayer, secondLayer, vy, px_collide, vx, topConcrete, secondConcrete);
                     bitmask = bitmaskMinusTop;
                     topLayer = secondLayer;
                     bitmaskMinusTop = bitmask & (~((uint32_t) 1 << topLayer));
                 }
             }
 
-            // Update depth tree for opened polygons (AVL tree for depth management)
-            if (TreeContains(v4p->openedPolygons, p)) {
-                // Leaving polygon - remove from tree
-                TreeDelete(v4p->openedPolygons, p);
+            // Update opened polygons (one parity bit per rank) and the visible polygon
+            v4p_timerStart(depthStart);
+            int rank = e->rank[i];
+            if (QuickBitsetToggle(band->openedPolygons, rank)) {
+                // Entering polygon
+                if (rank > visibleRank) {
+                    visibleRank = rank;
+                    visibleColor = ranks[rank].color;
+                }
+                v4p_count(band->stats, depthInserts, 1);
             } else {
-                // Entering polygon - add to tree
-                TreeInsert(v4p->openedPolygons, p);
+                // Leaving polygon
+                if (rank == visibleRank) {
+                    visibleRank = QuickBitsetMax(band->openedPolygons);
+                    visibleColor = visibleRank < 0 ? v4p->background : ranks[visibleRank].color;
+                }
+                v4p_count(band->stats, depthDeletes, 1);
             }
-
-            // Update visible polygon
-            visiblePolygon = (V4pPolygonP) TreeFindMax(v4p->openedPolygons);
+            v4p_timerStop(band->stats, depthTime, depthStart);
 
             // Handle collision detection (original array-based approach)
-            if (collisionCallback != NULL) {
+            if (v4p->collisionCallback != NULL) {
                 px_collide = vx;
-                if (p->collisionMask != 0) {
-                    V4pCollisionMask mask = p->collisionMask;
+                V4pCollisionMask mask = ranks[rank].collisionMask;
+                if (mask != 0) {
+                    V4pPolygonP p = v4p->rankedPolygons[rank];
                     if (!(concreteBitmask & mask)) {
                         concreteBitmask |= mask;
 
@@ -1637,27 +3303,323 @@ int v4p_render() {
 
         // Last slice
         if (pvx < v4p_displayWidth) {
-            if (pvx < v4p_displayWidth) {
-                v4pi_slice(vy, IMAX(0, pvx), v4p_displayWidth, visiblePolygon ? visiblePolygon->color : v4p->background);
-            }
+            v4p_slice(band, IMAX(0, pvx), v4p_displayWidth, visibleColor);
+        }
+
+        if (band->buffered) {  // keep spans until the band is flushed
+            band->rowEnds[vy - band->y0] = band->spansNb;
+        } else {
+            v4p_flushSpans(&band->stats, vy, band->spans, band->spansNb);
+            band->spansNb = 0;
         }
 
     }  // Y loop ;
 
-    l = v4p->openedAEList;
-    while (l) {
-        l = ListFree(l);
+    v4p_count(band->stats, edgesClosed, e->orderNb);
+    e->orderNb = e->slotsNb = e->freeSlotsNb = e->arcsNb = e->freeArcsNb = 0;  // all slots free at once
+}
+
+// called by v4p_parallelFor(), possibly from a worker thread
+static void v4p_renderBandTask(void* context, int i) {
+    V4pContextP c = (V4pContextP) context;
+    v4p_setContext(c);  // current contexts are per thread
+    v4pi_setContext(c->display);
+    v4p_renderBand(&c->bands[i]);
+}
+
+// Hand the buffered spans and collisions of a band over, in scanline order
+static void v4p_flushBand(V4pBand* band) {
+    int start = 0;
+    for (V4pCoord vy = band->y0; vy < band->y1; vy++) {
+        int end = band->rowEnds[vy - band->y0];
+        v4p_flushSpans(&v4p->stats, vy, band->spans + start, end - start);
+        start = end;
+    }
+    for (int i = 0; i < band->collisionsNb; i++) {
+        V4pCollision* c = &band->collisions[i];
+        v4p->collisionCallback(c->i1, c->i2, c->y, c->x1, c->x2, c->p1, c->p2);
+    }
+}
+
+// Get the next run of rows to render from row y, returns false if none
+// Dirty rows separated by a few clean ones are rendered at once, a band start being costly.
+static bool v4p_nextDirtyRun(V4pCoord y, V4pCoord* y0, V4pCoord* y1) {
+    V4pCoord last;
+    if (! v4p->partialRefresh || v4p->allDirty) {  // whole display
+        *y0 = 0;
+        *y1 = v4p_displayHeight;
+        return y == 0 && v4p_displayHeight > 0;
+    }
+    while (y < v4p_displayHeight && ! v4p->dirtyRows[y]) y++;
+    if (y == v4p_displayHeight) return false;
+    *y0 = last = y;
+    for (; y < v4p_displayHeight && y - last <= V4P_DIRTY_GAP; y++) {
+        if (v4p->dirtyRows[y]) last = y;
+    }
+    *y1 = last + 1;
+    return true;
+}
+
+// Split the rows to render into bands: one per run of dirty rows (the whole display without partial refresh),
+// runs being split into a few bands per thread for load balancing
+static int v4p_prepareBands() {
+    int i, j, k, n = 1, rows = 0, bandsNb = 0;
+    V4pCoord y, y0, y1, bandHeight;
+
+    for (y = 0; v4p_nextDirtyRun(y, &y0, &y1); y = y1) rows += y1 - y0;
+    if (v4p->threads > 1) {
+        n = IMIN(v4p->threads * 4, rows / 16);  // at least 16 scanlines per band
+        if (n < 1) n = 1;
+    }
+    bandHeight = IMAX((rows + n - 1) / n, 1);
+    for (y = 0; v4p_nextDirtyRun(y, &y0, &y1); y = y1) bandsNb += (y1 - y0 + bandHeight - 1) / bandHeight;
+
+    if (bandsNb > v4p->bandsSize) {
+        V4pBand* bands = v4p_realloc(v4p->bands, sizeof(V4pBand) * bandsNb);
+        if (! bands) {
+            return (v4p_error("v4p_prepareBands failed, cannot allocate %d bands\n", bandsNb), failure);
+        }
+        v4p->bands = bands;
+        for (i = v4p->bandsSize; i < bandsNb; i++) {
+            V4pBand* band = &bands[i];
+            v4p_memset(band, 0, sizeof(V4pBand));
+            band->openedPolygons = QuickBitsetNew(32);
+        }
+        v4p->bandsSize = bandsNb;
+    }
+    v4p->bandsNb = bandsNb;
+
+    i = 0;
+    for (y = 0; v4p_nextDirtyRun(y, &y0, &y1); y = y1) {
+        k = (y1 - y0 + bandHeight - 1) / bandHeight;
+        for (j = 0; j < k; j++, i++) {
+            V4pBand* band = &v4p->bands[i];
+            band->y0 = y0 + (y1 - y0) * j / k;
+            band->y1 = y0 + (y1 - y0) * (j + 1) / k;
+            band->buffered = (v4p->threads > 1 && bandsNb > 1);
+            band->failed = false;
+            band->spansNb = 0;
+            band->collisionsNb = 0;
+            v4p_memset(&band->stats, 0, sizeof(V4pRenderStats));
+            if (QuickBitsetReserve(band->openedPolygons, v4p->rankedPolygonsNb)) {
+                return (v4p_error("v4p_prepareBands failed, cannot allocate %d ranks\n", v4p->rankedPolygonsNb),
+                        failure);
+            }
+            if (band->buffered && band->y1 - band->y0 > band->rowEndsSize) {
+                v4p_free(band->rowEnds);
+                band->rowEndsSize = band->y1 - band->y0;
+                band->rowEnds = (int*) v4p_malloc(sizeof(int) * band->rowEndsSize);
+                if (! band->rowEnds) {
+                    band->rowEndsSize = 0;
+                    return (v4p_error("v4p_prepareBands failed, cannot allocate %d rows\n", band->y1 - band->y0),
+                            failure);
+                }
+            }
+        }
+    }
+    return success;
+}
+
+// Size the dirty rows of partial refresh to the display, the whole display being dirty after any view change
+static void v4p_prepareDirtyRows() {
+    if (v4p->changes & V4P_CHANGED_VIEW) v4p->allDirty = true;
+    if (v4p->dirtyRowsSize != v4p_displayHeight) {
+        v4p_free(v4p->dirtyRows);
+        v4p->dirtyRows = (uint8_t*) v4p_malloc(v4p_displayHeight);
+        v4p->dirtyRowsSize = v4p->dirtyRows ? v4p_displayHeight : 0;
+        v4p->allDirty = true;
+    }
+}
+
+// Size the openable table to the display, it is rebuilt after any view change
+static int v4p_prepareOpenableTable() {
+    if (v4p->openableAETable->sizeOfTable != (size_t) v4p_displayHeight + 1) {
+        QuickTable table = QuickTableNew(v4p_displayHeight + 1);
+        if (! table) {
+            return (v4p_error("v4p_prepareOpenableTable failed, cannot allocate %d rows\n", v4p_displayHeight), failure);
+        }
+        QuickTableDestroy(v4p->openableAETable);
+        v4p->openableAETable = table;
+        v4p->changes |= V4P_CHANGED_VIEW;
+    }
+    if (v4p->changes & V4P_CHANGED_VIEW) {
+        QuickTableReset(v4p->openableAETable);
+        v4p->tableGeneration++;  // no polygon is hashed anymore
+    }
+    return success;
+}
+
+#ifdef V4PI_PARTIAL
+#define V4P_DRAWERS 8
+
+// Last context rendered to a display from this thread, displays met last being kept
+static V4P_TLS struct {
+    V4piContextP display;
+    V4pContextP context;
+} v4p_drawers[V4P_DRAWERS];
+static V4P_TLS int v4p_drawersNext = 0;
+
+// Size the drawn rows to the display, none being known for a new display
+// Nor are they once another context rendered to the same display, or if this is not known anymore.
+static void v4p_prepareDrawnRows() {
+    int i = 0;
+    while (i < V4P_DRAWERS && v4p_drawers[i].display != v4p->display) i++;
+    if (i == V4P_DRAWERS) {  // replaces the display met first
+        i = v4p_drawersNext;
+        v4p_drawersNext = (i + 1) % V4P_DRAWERS;
+        v4p_drawers[i].display = v4p->display;
+        v4p_drawers[i].context = NULL;
+    }
+    if (v4p_drawers[i].context != v4p) v4p_invalidate();
+    v4p_drawers[i].context = v4p;
+
+    if (v4p->drawnDisplay == v4p->display && v4p->drawnRowsNb == v4p_displayHeight) return;
+    for (int y = 0; y < v4p->drawnRowsNb; y++) v4p_free(v4p->drawnRows[y].spans);
+    v4p_free(v4p->drawnRows);
+    v4p->drawnRows = (V4pDrawnRow*) v4p_malloc(sizeof(V4pDrawnRow) * v4p_displayHeight);
+    v4p->drawnRowsNb = v4p->drawnRows ? v4p_displayHeight : 0;  // no rows kept if failed
+    for (int y = 0; y < v4p->drawnRowsNb; y++) {
+        v4p->drawnRows[y].spans = NULL;
+        v4p->drawnRows[y].spansNb = -1;
+        v4p->drawnRows[y].spansSize = 0;
+    }
+    v4p->drawnDisplay = v4p->display;
+    v4p->allDirty = true;
+}
+#endif
+
+// Render a scene
+int v4p_render() {
+    v4p_trace(SCAN, "v4p_render\n");
+    v4p_timerStart(renderStart);
+
+    int i, rc = success;
+
+    v4pi_setContext(v4p->display);
+
+    v4pi_start();
+
+    if (v4p_prepareOpenableTable()) {
+        v4pi_end();
+        return failure;
+    }
+#ifdef V4PI_PARTIAL
+    v4p_prepareDrawnRows();
+#endif
+    if (v4p->partialRefresh) v4p_prepareDirtyRows();
+
+    // Update AE lists and the openable table
+    v4p_timerStart(buildStart);
+    v4p->rankedPolygonsNb = 0;
+    if (! v4p->scene->grid) {
+        v4p_buildOpenableAELists(v4p->scene->polygons);
+    } else if (v4p_buildGridAELists(v4p->scene)) {
+        v4pi_end();
+        return failure;
+    }
+    v4p_timerStop(v4p->stats, buildTime, buildStart);
+
+    // Rank visible polygons by depth then split the rows to render into bands
+    if (v4p_rankPolygons() || v4p_prepareBands()) {
+        v4pi_end();
+        return failure;
+    }
+
+    // Render bands, in parallel when they are buffered
+    if (v4p->bandsNb > 0 && v4p->bands[0].buffered) {
+        v4p_parallelFor(v4p->bandsNb, v4p_renderBandTask, v4p, v4p->threads);
+    }
+    for (i = 0; i < v4p->bandsNb; i++) {
+        V4pBand* band = &v4p->bands[i];
+        if (! band->buffered) {
+            v4p_renderBand(band);
+        } else if (! band->failed) {
+            v4p_flushBand(band);
+        }
+#ifdef V4PI_PARTIAL
+        v4pi_damage(band->y0, band->y1);
+#endif
+        v4p_addRenderStats(&v4p->stats, &band->stats);
+        if (band->failed) rc = failure;
     }
-    v4p->openedAEList = NULL;
 
-    if (y != v4p->viewMaxY - v4p->viewToScreen_wholeY) {
-        v4p_error("problem %d != %d", (int) y, (int) v4p->viewMaxY - v4p->viewToScreen_wholeY);
+    // Rendered rows are clean
+    if (v4p->partialRefresh && v4p->dirtyRows) {
+        v4p_memset(v4p->dirtyRows, 0, v4p->dirtyRowsSize);
+        v4p->allDirty = (rc != success);
     }
 
     v4p->changes = 0;
     v4pi_end();
-    return success;
+    v4p_count(v4p->stats, frames, 1);
+    v4p_timerStop(v4p->stats, totalTime, renderStart);
+    return rc;
+}
+
+// Is a display point within a polygon as drawn at last frame
+// Only the edges crossing the point row are opened there, on private copies, then the
+// point is inside if an odd count of them toggles the polygon at its left (see v4p_renderBand).
+static bool v4p_isPicked(V4pPolygonP p, V4pCoord x, V4pCoord y) {
+    bool inside = false;
+    for (List l = p->ActiveEdge1; l; l = ListNext(l)) {
+        ActiveEdgeP ae = (ActiveEdgeP) ListData(l);
+        if (ae->avy > y || ae->bvy <= y) continue;  // not opened at row y
+        ActiveEdge copy = *ae;
+        v4p_initActiveEdge(&copy, y);
+        if (copy.x <= x) inside = ! inside;
+    }
+    return inside;
+}
+
+// Insert a polygon and its subs drawn at a display point into picked[], by decreasing rank
+// Culled subtrees are skipped at once, they were not drawn.
+static void v4p_pickTree(V4pPolygonP p, V4pCoord x, V4pCoord y, bool masked, V4pCollisionMask mask,
+                         V4pPolygonP* picked, int max, int* pickedNb) {
+    if (p->props & V4P_CULLED) return;
+    if (p->ActiveEdge1 && p->minyv <= y && y < p->maxyv && (! masked || (p->collisionMask & mask))
+        && v4p_isPicked(p, x, y)) {
+        int i = *pickedNb < max ? (*pickedNb)++ : max;
+        for (; i > 0 && picked[i - 1]->rank < p->rank; i--) {
+            if (i < max) picked[i] = picked[i - 1];
+        }
+        if (i < max) picked[i] = p;
+    }
+    for (V4pPolygonP s = p->sub1; s; s = s->next) v4p_pickTree(s, x, y, masked, mask, picked, max, pickedNb);
 }
+
+// Polygons drawn at a display point at last frame, topmost first
+// A gridded scene visits the trees shown at last frame only.
+static int v4p_pickIn(V4pCoord x, V4pCoord y, bool masked, V4pCollisionMask mask, V4pPolygonP* picked, int max) {
+    V4pGrid* g = v4p->scene->grid;
+    int pickedNb = 0;
+
+    if (x < 0 || y < 0 || x >= v4p_displayWidth || y >= v4p_displayHeight || max <= 0) return 0;
+    if (g && g->query) {  // grid queried at last frame
+        for (int i = 0; i < g->shownNb; i++) v4p_pickTree(g->shown[i]->p, x, y, masked, mask, picked, max, &pickedNb);
+    } else {
+        for (V4pPolygonP p = v4p->scene->polygons; p; p = p->next)
+            v4p_pickTree(p, x, y, masked, mask, picked, max, &pickedNb);
+    }
+    return pickedNb;
+}
+
+// Topmost polygon drawn at a display point
+V4pPolygonP v4p_pick(V4pCoord x, V4pCoord y) {
+    V4pPolygonP p;
+    return v4p_pickIn(x, y, false, 0, &p, 1) ? p : NULL;
+}
+
+// Topmost polygon drawn at a display point, among those sharing a collision layer with mask
+V4pPolygonP v4p_pickMasked(V4pCoord x, V4pCoord y, V4pCollisionMask mask) {
+    V4pPolygonP p;
+    return v4p_pickIn(x, y, true, mask, &p, 1) ? p : NULL;
+}
+
+// All polygons drawn at a display point, topmost first
+int v4p_pickAll(V4pCoord x, V4pCoord y, V4pPolygonP* picked, int max) {
+    return v4p_pickIn(x, y, false, 0, picked, max);
+}
+
 // Add 4 points as a rectangle
 V4pPolygonP v4p_addCorners(V4pPolygonP p, V4pCoord x0, V4pCoord y0, V4pCoord x1, V4pCoord y1) {
     v4p_addPoint(p, x0, y0);
@@ -1699,5 +3661,10 @@ V4pPolygonP v4p_addRoundCorners(V4pPolygonP p, V4pCoord x0, V4pCoord y0, V4pCoor
 
 // Set the collision callback
 void v4p_setCollisionCallback(V4pCollisionCallback callback) {
-    collisionCallback = callback;
+    v4p->collisionCallback = callback;
+}
+
+// Get the collision callback
+V4pCollisionCallback v4p_getCollisionCallback() {
+    return v4p->collisionCallback;
 }
@@ -20,6 +20,9 @@ typedef uint16_t V4pFlag;
 #define V4P_DISABLED (V4pFlag) 32  // wont be displayed for now
 #define V4P_IN_DISABLED (V4pFlag) 64  // ancester disabled
 #define V4P_CHANGED (V4pFlag) 128  // definition changed since last rendering
+#define V4P_TREE_CHANGED (V4pFlag) 256  // polygon or sub changed since its subtree box was computed
+#define V4P_CULLED (V4pFlag) 512  // subtree out of view, its active edges freed
+#define V4P_INSTANCE (V4pFlag) 1024  // drawn with the transformed points of its parent (see v4p_newInstance)
 
 // Quality vs. Perfs Levels
 #define V4P_QUALITY_LOW 0
@@ -39,12 +42,18 @@ typedef struct v4p_context_s* V4pContextP;
 typedef struct v4p_scene_s {
     const char* label;
     V4pPolygonP polygons;
+    struct v4p_grid_s* grid;  // Optional spatial index (see v4p_setSceneGrid)
 } V4pScene, *V4pSceneP;
 
+// Polygon points, listed from the last added one (see v4p_getPoints and v4p_nextPoint)
+// Packed builds (make PACKED=1) hold the points of a polygon in one array instead of linked points: adding or
+// removing a point then moves the points of the polygon, and former V4pPointP to them are not to be used anymore.
 typedef struct v4p_point_s {
     V4pCoord x, y;
     uint16_t a, b;
+#ifndef V4P_PACKED
     V4pPointP next;
+#endif
 } V4pPoint;
 
 #define V4P_NIL ((V4pCoord) INT32_MAX)
@@ -52,6 +61,11 @@ typedef struct v4p_point_s {
 // Arc center point encoding macros
 #define V4P_IS_ARC_CENTER(p) (p->a != 0)
 
+// Bezier control point encoding macros
+// One control point between two path points bends their edge into a quadratic curve, two into a cubic one.
+#define V4P_CONTROL_POINT ((uint16_t) 0xFFFF)
+#define V4P_IS_CONTROL_POINT(p) (p->a == 0 && p->b == V4P_CONTROL_POINT)
+
 /**
  * Variables
  */
@@ -59,8 +73,8 @@ extern V4pContextP v4p_defaultContext;  // Default context (set once by v4pinit(
 extern V4pSceneP v4p_defaultScene;  // Default scene within default context (set
                                     // once by v4pinit())
 
-extern V4pCoord v4p_displayWidth;  // current display width
-extern V4pCoord v4p_displayHeight;  // current display height
+extern V4P_TLS V4pCoord v4p_displayWidth;  // current display width (per thread)
+extern V4P_TLS V4pCoord v4p_displayHeight;  // current display height (per thread)
 
 /**
  * Functions
@@ -88,6 +102,12 @@ V4pSceneP v4p_sceneAdd(V4pSceneP, V4pPolygonP);
 V4pSceneP v4p_sceneRemove(V4pSceneP, V4pPolygonP);
 void v4p_clearScene();
 
+// Index the scene polygons in a grid of cellSize wide cells (0 to drop the grid)
+// Frames then visit only polygon trees overlapping the view, instead of walking the whole
+// scene. Worth it for large worlds showing a small part of their mostly still polygons.
+// Larger trees are indexed in coarser cells, cellSize being best around the common size.
+int v4p_setSceneGrid(V4pSceneP, V4pCoord cellSize);
+
 // v4p view
 void v4p_viewToAbsolute(V4pCoord x, V4pCoord y, V4pCoord* xa, V4pCoord* ya);
 void v4p_absoluteToView(V4pCoord x, V4pCoord y, V4pCoord* xa, V4pCoord* ya);
@@ -95,7 +115,13 @@ void v4p_absoluteToView(V4pCoord x, V4pCoord y, V4pCoord* xa, V4pCoord* ya);
 // v4p polygon
 V4pPolygonP v4p_new(V4pProps t, V4pColor col, V4pLayer z);
 V4pPolygonP v4p_newDisk(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t radius);
+V4pPolygonP v4p_newEllipse(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t a,
+                           uint16_t b);
 V4pPolygonP v4p_clone(V4pPolygonP p);
+// Instances are drawn with the points of their prototype, transformed by v4p_transform when their edges are
+// built: they hold no point, and moving them transforms no point list. They follow the changes of their prototype
+// and its subs, and are left empty if it is destroyed.
+V4pPolygonP v4p_newInstance(V4pPolygonP proto);
 V4pPolygonP v4p_setCollisionMask(V4pPolygonP p, V4pCollisionMask collisionMask);
 V4pPolygonP v4p_intoList(V4pPolygonP p, V4pPolygonP* list);
 int v4p_outOfList(V4pPolygonP p, V4pPolygonP* list);
@@ -108,6 +134,7 @@ V4pProps v4p_removeProp(V4pPolygonP p, V4pProps i);
 V4pProps v4p_setRelative(V4pPolygonP p, bool relative);
 V4pPointP v4p_addPoint(V4pPolygonP p, V4pCoord x, V4pCoord y);
 V4pPointP v4p_addEllipseCenter(V4pPolygonP p, V4pCoord x, V4pCoord y, V4pCoord a, V4pCoord b);
+V4pPointP v4p_addControlPoint(V4pPolygonP p, V4pCoord x, V4pCoord y);
 V4pPointP v4p_addJump(V4pPolygonP p);
 V4pPointP v4p_movePoint(V4pPolygonP p, V4pPointP s, V4pCoord x, V4pCoord y);
 V4pColor v4p_setColor(V4pPolygonP p, V4pColor c);
@@ -115,6 +142,7 @@ V4pLayer v4p_setLayer(V4pPolygonP p, V4pLayer z);
 int  v4p_setVisibility(V4pPolygonP p, bool visible);
 uint32_t   v4p_setStroke(V4pPolygonP p, uint32_t stroke);
 V4pPointP v4p_getPoints(V4pPolygonP p);
+V4pPointP v4p_nextPoint(V4pPointP s);
 V4pLayer v4p_getLayer(V4pPolygonP p);
 V4pCollisionMask v4p_getCollisionMask(V4pPolygonP p);
 uint32_t v4p_getId(V4pPolygonP p);
@@ -137,6 +165,18 @@ V4pPolygonP v4p_transform(V4pPolygonP p, V4pCoord dx, V4pCoord dy, int angle, V4
                           V4pCoord zoom_y);
 V4pPolygonP v4p_centerPolygon(V4pPolygonP p);
 
+// Batch transformation: polygons transformed as by v4p_transform, their points being transformed together
+// Jobs are transformed grouped by angle, possibly by several threads. A job depending on former ones (a polygon
+// transformed twice, or along with clones of it) is transformed after them.
+typedef struct v4p_transform_job_s {
+    V4pPolygonP p;  // Polygon to be transformed
+    V4pCoord dx, dy;
+    int angle;
+    V4pLayer dz;
+    V4pCoord zoom_x, zoom_y;
+} V4pTransformJob;
+int v4p_transformBatch(const V4pTransformJob* jobs, int n);
+
 
 
 // anchor point management
@@ -151,18 +191,75 @@ V4pPolygonP v4p_remove(V4pPolygonP);
 V4pPolygonP v4p_sceneAddNewPoly(V4pSceneP, V4pProps t, V4pColor col, V4pLayer z);
 V4pPolygonP v4p_sceneAddNewDisk(V4pSceneP, V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y,
                                 uint16_t radius);
+V4pPolygonP v4p_sceneAddNewEllipse(V4pSceneP, V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x,
+                                   V4pCoord center_y, uint16_t a, uint16_t b);
 V4pPolygonP v4p_sceneAddClone(V4pSceneP, V4pPolygonP p);
+V4pPolygonP v4p_sceneAddNewInstance(V4pSceneP, V4pPolygonP proto);
 V4pPolygonP v4p_addNew(V4pProps t, V4pColor col, V4pLayer z);
 V4pPolygonP v4p_addNewDisk(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t radius); 
+V4pPolygonP v4p_addNewEllipse(V4pProps t, V4pColor col, V4pLayer z, V4pCoord center_x, V4pCoord center_y, uint16_t a,
+                              uint16_t b);
 V4pPolygonP v4p_addClone(V4pPolygonP p);
+V4pPolygonP v4p_addNewInstance(V4pPolygonP proto);
 int v4p_destroy(V4pPolygonP p);
 int v4p_destroyFromScene(V4pPolygonP p);
 
+// Render statistics, accumulated by v4p_render() since the last reset
+// Only collected when built with STATS=1 (counters) or STATS=2 (counters and timings),
+// otherwise they stay at zero. Timings are intrusive: they slow down the rendering.
+typedef struct v4p_render_stats_s {
+    // Timings (nanoseconds)
+    int64_t totalTime;  // whole v4p_render()
+    int64_t buildTime;  // v4p_buildOpenableAELists()
+    int64_t openTime;  // v4p_openActiveEdge()
+    int64_t shiftTime;  // opened edges shift loop
+    int64_t sortTime;  // opened edges sort by x
+    int64_t depthTime;  // opened polygons depth tracking (topmost polygon)
+    int64_t sliceTime;  // v4pi_slice()
+    // Counters
+    uint32_t frames;  // rendered frames
+    uint32_t edgesBuilt;  // active edges (re)built
+    uint32_t edgesOpened;  // active edges opened at their top scanline
+    uint32_t edgesClosed;  // active edges closed
+    uint32_t sorts;  // opened edges list sorts
+    uint32_t depthInserts;  // polygons opened at a scanline
+    uint32_t depthDeletes;  // polygons closed at a scanline
+    uint32_t slices;  // slices emitted
+    uint32_t rowsSkipped;  // scanlines not handed over, same as drawn at a previous frame
+    uint32_t collisions;  // collision callbacks fired
+} V4pRenderStats;
+
+const V4pRenderStats* v4p_getRenderStats();  // stats of the current context
+void v4p_resetRenderStats();
+
+// Render only the rows changed since last frame (off by default)
+// Needs a backend keeping its pixels (built with V4PI_PARTIAL), returns failure otherwise.
+// Collisions are then reported for rendered rows only.
+int v4p_setPartialRefresh(bool enabled);
+
+// Forget what the display shows: the next frame draws all its rows
+// Call it after the display pixels were overwritten outside v4p_render() (other contexts rendering to the
+// same display from the same thread are noticed).
+void v4p_invalidate();
+
+// Render the current context with n threads, in horizontal bands (build with THREADS=1)
+// Returns the thread count in use (always 1 when built without threads support)
+int v4p_setRenderThreads(int n);
+
 // Collision detection when rendering
 typedef void (*V4pCollisionCallback)(V4pCollisionLayer i1, V4pCollisionLayer i2, V4pCoord py, V4pCoord x1, V4pCoord x2,
                                      V4pPolygonP p1, V4pPolygonP p2);
 
-// Collision callback function (see game engine implmentation)
+// Collision callback function of the current context (see game engine implmentation)
+// New contexts inherit the one of the default context
 void v4p_setCollisionCallback(V4pCollisionCallback f);
+V4pCollisionCallback v4p_getCollisionCallback();
+
+// Picking: polygons drawn at a display point (x, y) by the last v4p_render()
+// Only the edges crossing row y are stepped, no frame is rendered. Polygons changed since
+// are found as drawn. Hidden, disabled or out of view polygons are never picked.
+V4pPolygonP v4p_pick(V4pCoord x, V4pCoord y);  // topmost one, NULL over the background
+V4pPolygonP v4p_pickMasked(V4pCoord x, V4pCoord y, V4pCollisionMask mask);  // topmost one sharing a collision layer with mask
+int v4p_pickAll(V4pCoord x, V4pCoord y, V4pPolygonP* picked, int max);  // up to max ones topmost first, returns their count
 
 #endif